@@ -13,10 +13,15 @@
       ],
       "sources": [
         "src/main.cc",
-        "src/WindowManager.cc"
+        "src/WindowManager.cc",
+        "src/Win32WindowBackend.cc",
+        "src/ProcessSampler.cc",
+        "src/FocusRouter.cc",
+        "src/TraceRecorder.cc"
       ],
       "conditions": [
         ["OS=='win'", {
+          "libraries": ["-lpsapi"],
           "msvs_settings": {
             "VCCLCompilerTool": {
               "ExceptionHandling": 1,
@@ -24,6 +24,28 @@ try {
   nativeAddon = null;
 }
 
+// 设置 WM_TRACE=<文件路径> 时录制所有窗口操作，可用 tools/ 下的 wm_replay 回放
+// 诊断功能启动失败只记录日志，不影响窗口嵌入
+if (nativeAddon && process.env.WM_TRACE) {
+  try {
+    nativeAddon.startTraceRecording(process.env.WM_TRACE);
+  } catch (error) {
+    console.error("Failed to start trace recording:", error);
+  }
+}
+
+// 资源采样线程在第一次读取快照时才启动
+let resourceSamplerStarted = false;
+
+function ensureResourceSampler() {
+  if (resourceSamplerStarted) {
+    return;
+  }
+  // 后台线程批量采集所有嵌入进程的资源占用，JS 侧只需按需读取快照
+  nativeAddon.startResourceSampler({ intervalMs: 1000, historySize: 60 });
+  resourceSamplerStarted = true;
+}
+
 function createWindow() {
   mainWindow = new BrowserWindow({
     width: 1200,
@@ -48,6 +70,17 @@ function createWindow() {
 
   mainWindow.loadFile("index.html");
 
+  if (nativeAddon) {
+    // 焦点进出嵌入窗口、以及被交还给宿主的快捷键，都由原生层直接通知
+    nativeAddon.setFocusListener((event) => {
+      if (mainWindow && !mainWindow.isDestroyed()) {
+        mainWindow.webContents.send("embedded-focus-event", event);
+      }
+    });
+    // 焦点在嵌入程序内时，这些快捷键不再被嵌入程序吞掉，而是交还给宿主
+    nativeAddon.setAcceleratorPassthrough(["Ctrl+Tab", "Ctrl+Shift+Tab"]);
+  }
+
   mainWindow.on("closed", () => {
     // 清理所有嵌入的窗口
     if (nativeAddon) {
@@ -188,10 +221,10 @@ ipcMain.handle("create-embedded-window", async (event, options) => {
     // 关键：设置窗口层级和焦点
     setTimeout(() => {
       embeddedWindow.show();
-      // 确保窗口接收输入焦点
-      embeddedWindow.focus();
       // 确保窗口在正确的层级
       embeddedWindow.moveTop();
+      // 确保嵌入程序直接接收键盘输入
+      nativeAddon.focusWindow(windowId);
     }, 300);
 
     console.log("Created embedded window:", windowId);
@@ -295,7 +328,7 @@ ipcMain.handle("show-window", async (event, windowId, show) => {
     if (embeddedWindow && !embeddedWindow.isDestroyed()) {
       if (show) {
         embeddedWindow.show();
-        embeddedWindow.focus(); // 关键：确保获得焦点
+        nativeAddon.focusWindow(windowId); // 关键：键盘焦点直接进入嵌入程序
       } else {
         embeddedWindow.hide();
       }
@@ -309,6 +342,21 @@ ipcMain.handle("show-window", async (event, windowId, show) => {
   }
 });
 
+// 聚焦窗口：原生层一次性完成前台切换和键盘焦点移交
+ipcMain.handle("focus-window", async (event, windowId) => {
+  if (!nativeAddon) {
+    throw new Error("Native addon not loaded");
+  }
+
+  try {
+    const result = nativeAddon.focusWindow(windowId);
+    return { success: result };
+  } catch (error) {
+    console.error("Failed to focus window:", error);
+    return { success: false, error: error.message };
+  }
+});
+
 // 销毁窗口
 ipcMain.handle("destroy-window", async (event, windowId) => {
   if (!nativeAddon) {
@@ -347,6 +395,41 @@ ipcMain.handle("get-all-window-ids", async () => {
   }
 });
 
+// 获取资源占用快照（每个窗口的最新值 + 历史记录）
+ipcMain.handle("get-resource-snapshot", async () => {
+  if (!nativeAddon) {
+    throw new Error("Native addon not loaded");
+  }
+
+  try {
+    ensureResourceSampler();
+    const { ids, fields, capacity, counts, samples } =
+      nativeAddon.getResourceSnapshot();
+    const stride = capacity * fields.length;
+    const windows = {};
+    ids.forEach((id, i) => {
+      const count = counts[i];
+      // history 为同一个 Float64Array 的视图，IPC 按类型化数组原样传输（底层缓冲区只传一次）
+      const history = samples.subarray(
+        i * stride,
+        i * stride + count * fields.length
+      );
+      const latest = {};
+      if (count > 0) {
+        const offset = (count - 1) * fields.length;
+        fields.forEach((name, f) => {
+          latest[name] = history[offset + f];
+        });
+      }
+      windows[id] = { latest, history };
+    });
+    return { success: true, fields, windows };
+  } catch (error) {
+    console.error("Failed to get resource snapshot:", error);
+    return { success: false, error: error.message };
+  }
+});
+
 // 清理所有窗口
 ipcMain.handle("cleanup-all", async () => {
   if (!nativeAddon) {
@@ -391,7 +474,12 @@ app.on("before-quit", () => {
   // 确保在退出前清理所有窗口
   if (nativeAddon) {
     try {
+      nativeAddon.setFocusListener(null);
+      if (resourceSamplerStarted) {
+        nativeAddon.stopResourceSampler();
+      }
       nativeAddon.cleanupAll();
+      nativeAddon.stopTraceRecording();
     } catch (error) {
       console.error("Error during cleanup:", error);
     }
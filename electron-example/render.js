@@ -28,6 +28,7 @@ async function updateWindowList() {
         div.innerHTML = `
                     <strong>${id}</strong><br>
                     程序: ${info ? info.exePath : "Unknown"}<br>
+                    <span class="resource" data-resource-id="${id}">资源: 采样中...</span><br>
                     <button onclick="focusWindow('${id}')">聚焦</button>
                     <button onclick="hideWindow('${id}')">隐藏</button>
                     <button onclick="showWindow('${id}')">显示</button>
@@ -44,15 +45,54 @@ async function updateWindowList() {
   }
 }
 
+function formatBytes(bytes) {
+  return (bytes / 1024 / 1024).toFixed(1) + " MB";
+}
+
+// 刷新各窗口的资源占用（原生采样线程定时采集，这里只读取最新一行）
+async function updateResourceUsage() {
+  const items = document.querySelectorAll("[data-resource-id]");
+  // 没有窗口时不读取，采样线程也就不会被启动
+  if (items.length === 0) {
+    return;
+  }
+
+  try {
+    const result = await ipcRenderer.invoke("get-resource-snapshot");
+    if (!result.success) {
+      return;
+    }
+    items.forEach((item) => {
+      const usage = result.windows[item.dataset.resourceId];
+      if (!usage || usage.history.length === 0) {
+        return;
+      }
+      const { latest } = usage;
+      item.textContent =
+        `CPU ${latest.cpuPercent.toFixed(1)}%  ` +
+        `内存 ${formatBytes(latest.workingSet)}  ` +
+        `私有 ${formatBytes(latest.privateBytes)}  ` +
+        `句柄 ${latest.handleCount}  线程 ${latest.threadCount}`;
+    });
+  } catch (error) {
+    console.error("读取资源占用失败:", error);
+  }
+}
+
+// 原生焦点事件
+ipcRenderer.on("embedded-focus-event", (event, data) => {
+  if (data.type === "accelerator") {
+    log(`快捷键 ${data.accelerator} 已从 ${data.id} 交还给宿主`);
+  } else {
+    log(`${data.id} ${data.type === "focusin" ? "获得" : "失去"}焦点`);
+  }
+});
+
 // 聚焦窗口（新增功能）
 window.focusWindow = async (windowId) => {
   try {
     log(`正在聚焦窗口: ${windowId}`);
-    // 通过更新窗口来触发聚焦
-    const result = await ipcRenderer.invoke("update-window", windowId, {
-      width: 800, // 保持当前尺寸
-      height: 600,
-    });
+    const result = await ipcRenderer.invoke("focus-window", windowId);
 
     if (result.success) {
       log(`窗口已聚焦: ${windowId}`, "success");
@@ -224,4 +264,5 @@ window.createMspaint = () => {
 document.addEventListener("DOMContentLoaded", () => {
   log("BrowserWindowTool 已就绪", "success");
   updateWindowList();
+  setInterval(updateResourceUsage, 1000);
 });
@@ -0,0 +1,402 @@
+#include "FocusRouter.h"
+#include "WindowManager.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace
+{
+std::string ToLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c)
+                   { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+std::string Trim(const std::string &text)
+{
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos)
+    {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+struct NamedKey
+{
+    const char *name;
+    UINT key;
+};
+
+const NamedKey kNamedKeys[] = {
+    {"tab", VK_TAB},
+    {"space", VK_SPACE},
+    {"enter", VK_RETURN},
+    {"return", VK_RETURN},
+    {"esc", VK_ESCAPE},
+    {"escape", VK_ESCAPE},
+    {"backspace", VK_BACK},
+    {"delete", VK_DELETE},
+    {"insert", VK_INSERT},
+    {"home", VK_HOME},
+    {"end", VK_END},
+    {"pageup", VK_PRIOR},
+    {"pagedown", VK_NEXT},
+    {"up", VK_UP},
+    {"down", VK_DOWN},
+    {"left", VK_LEFT},
+    {"right", VK_RIGHT},
+};
+
+// 钩子线程收到此消息后按当前配置安装或卸载键盘钩子
+const UINT kUpdateHooksMessage = WM_APP + 1;
+
+bool IsKeyDown(int vk)
+{
+    return (GetAsyncKeyState(vk) & 0x8000) != 0;
+}
+
+HWND CurrentFocus()
+{
+    GUITHREADINFO info = {};
+    info.cbSize = sizeof(info);
+    return GetGUIThreadInfo(0, &info) ? info.hwndFocus : NULL;
+}
+}
+
+FocusRouter &FocusRouter::Instance()
+{
+    static FocusRouter instance;
+    return instance;
+}
+
+FocusRouter::FocusRouter() : hookThreadId_(0), keyboardHook_(NULL), swallowedKey_(0)
+{
+    // 钩子线程会调用 WindowManager，先构造它以保证其在本对象之后析构
+    WindowManager::Instance();
+}
+
+FocusRouter::~FocusRouter()
+{
+    Reset();
+}
+
+void FocusRouter::SetListener(Listener listener)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        listener_ = listener;
+    }
+    UpdateHooks();
+}
+
+bool FocusRouter::SetAccelerators(const std::vector<std::string> &accelerators, std::string &error)
+{
+    std::vector<AcceleratorKey> parsed;
+    for (const auto &text : accelerators)
+    {
+        AcceleratorKey accelerator;
+        if (!ParseAccelerator(text, accelerator))
+        {
+            error = "Invalid accelerator: " + text;
+            return false;
+        }
+        parsed.push_back(accelerator);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        accelerators_ = parsed;
+    }
+    UpdateHooks();
+    return true;
+}
+
+std::string FocusRouter::FocusedId() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return focusedId_;
+}
+
+void FocusRouter::Reset()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        listener_ = nullptr;
+        accelerators_.clear();
+    }
+    UpdateHooks();
+}
+
+void FocusRouter::UpdateHooks()
+{
+    bool wantHooks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wantHooks = static_cast<bool>(listener_);
+    }
+
+    if (wantHooks && !hookThread_.joinable())
+    {
+        std::promise<DWORD> started;
+        std::future<DWORD> threadId = started.get_future();
+        hookThread_ = std::thread(&FocusRouter::HookThreadMain, this, std::move(started));
+        hookThreadId_ = threadId.get();
+    }
+    else if (!wantHooks && hookThread_.joinable())
+    {
+        PostThreadMessageW(hookThreadId_, WM_QUIT, 0, 0);
+        hookThread_.join();
+        hookThreadId_ = 0;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        focusedId_.clear();
+    }
+    else if (wantHooks)
+    {
+        PostThreadMessageW(hookThreadId_, kUpdateHooksMessage, 0, 0);
+    }
+}
+
+void FocusRouter::HookThreadMain(std::promise<DWORD> started)
+{
+    // 先建立消息队列，保证返回后主线程投递的消息不会丢失
+    MSG msg;
+    PeekMessageW(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+
+    // 跨进程焦点变化只能通过全局 WinEvent 钩子获得；OUTOFCONTEXT 回调在本线程的消息循环中执行
+    HWINEVENTHOOK focusHook = SetWinEventHook(EVENT_OBJECT_FOCUS, EVENT_OBJECT_FOCUS, NULL,
+                                              &FocusRouter::WinEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+    started.set_value(GetCurrentThreadId());
+
+    OnFocusChanged(CurrentFocus());
+    UpdateKeyboardHook();
+
+    // 本线程只处理钩子回调，不会阻塞，低级键盘钩子不会因超时被系统摘除
+    while (GetMessageW(&msg, NULL, 0, 0) > 0)
+    {
+        if (msg.hwnd == NULL && msg.message == kUpdateHooksMessage)
+        {
+            UpdateKeyboardHook();
+            continue;
+        }
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
+    }
+
+    if (keyboardHook_)
+    {
+        UnhookWindowsHookEx(keyboardHook_);
+        keyboardHook_ = NULL;
+        swallowedKey_ = 0;
+    }
+    if (focusHook)
+    {
+        UnhookWinEvent(focusHook);
+    }
+}
+
+void FocusRouter::UpdateKeyboardHook()
+{
+    bool wantKeyboardHook;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wantKeyboardHook = listener_ && !accelerators_.empty();
+    }
+
+    if (wantKeyboardHook && !keyboardHook_)
+    {
+        keyboardHook_ = SetWindowsHookExW(WH_KEYBOARD_LL, &FocusRouter::KeyboardProc, GetModuleHandle(NULL), 0);
+    }
+    else if (!wantKeyboardHook && keyboardHook_)
+    {
+        UnhookWindowsHookEx(keyboardHook_);
+        keyboardHook_ = NULL;
+        swallowedKey_ = 0;
+    }
+}
+
+void FocusRouter::OnFocusChanged(HWND hwnd)
+{
+    // 沿父窗口（弹出窗口则为所有者）向上查找所属容器
+    std::string id;
+    HWND current = hwnd;
+    for (int depth = 0; current && depth < 32; ++depth)
+    {
+        id = WindowManager::Instance().FindIdByContainer(current);
+        if (!id.empty())
+        {
+            break;
+        }
+        current = GetParent(current);
+    }
+
+    // 在锁内回调，SetListener(nullptr) 返回后不会再有进行中的回调
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id == focusedId_)
+    {
+        return;
+    }
+
+    std::string previous = focusedId_;
+    focusedId_ = id;
+
+    if (!listener_)
+    {
+        return;
+    }
+    if (!previous.empty())
+    {
+        listener_(FocusEvent{FocusEvent::FocusOut, previous, ""});
+    }
+    if (!id.empty())
+    {
+        listener_(FocusEvent{FocusEvent::FocusIn, id, ""});
+    }
+}
+
+bool FocusRouter::OnKeyDown(DWORD vkCode)
+{
+    bool ctrl = IsKeyDown(VK_CONTROL);
+    bool shift = IsKeyDown(VK_SHIFT);
+    bool alt = IsKeyDown(VK_MENU);
+    bool win = IsKeyDown(VK_LWIN) || IsKeyDown(VK_RWIN);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (focusedId_.empty() || !listener_)
+    {
+        return false;
+    }
+
+    for (const auto &accelerator : accelerators_)
+    {
+        if (accelerator.key == vkCode &&
+            accelerator.ctrl == ctrl &&
+            accelerator.shift == shift &&
+            accelerator.alt == alt &&
+            accelerator.win == win)
+        {
+            listener_(FocusEvent{FocusEvent::Accelerator, focusedId_, accelerator.name});
+            return true;
+        }
+    }
+    return false;
+}
+
+void CALLBACK FocusRouter::WinEventProc(HWINEVENTHOOK, DWORD event, HWND hwnd,
+                                        LONG, LONG, DWORD, DWORD)
+{
+    if (event == EVENT_OBJECT_FOCUS)
+    {
+        Instance().OnFocusChanged(hwnd);
+    }
+}
+
+LRESULT CALLBACK FocusRouter::KeyboardProc(int code, WPARAM wparam, LPARAM lparam)
+{
+    if (code == HC_ACTION)
+    {
+        FocusRouter &router = Instance();
+        const KBDLLHOOKSTRUCT *key = reinterpret_cast<const KBDLLHOOKSTRUCT *>(lparam);
+
+        if (wparam == WM_KEYDOWN || wparam == WM_SYSKEYDOWN)
+        {
+            if (router.OnKeyDown(key->vkCode))
+            {
+                router.swallowedKey_ = key->vkCode;
+                return 1;
+            }
+        }
+        else if ((wparam == WM_KEYUP || wparam == WM_SYSKEYUP) && key->vkCode == router.swallowedKey_)
+        {
+            // 按下已被宿主接管，松开也不再交给嵌入程序
+            router.swallowedKey_ = 0;
+            return 1;
+        }
+    }
+    return CallNextHookEx(NULL, code, wparam, lparam);
+}
+
+bool FocusRouter::ParseAccelerator(const std::string &text, AcceleratorKey &accelerator)
+{
+    accelerator = AcceleratorKey{0, false, false, false, false, text};
+
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        size_t end = text.find('+', start);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+        std::string part = ToLower(Trim(text.substr(start, end - start)));
+        start = end + 1;
+
+        if (part.empty())
+        {
+            return false;
+        }
+
+        if (part == "ctrl" || part == "control" || part == "cmdorctrl" || part == "commandorcontrol")
+        {
+            accelerator.ctrl = true;
+            continue;
+        }
+        if (part == "shift")
+        {
+            accelerator.shift = true;
+            continue;
+        }
+        if (part == "alt" || part == "option")
+        {
+            accelerator.alt = true;
+            continue;
+        }
+        if (part == "super" || part == "meta" || part == "win")
+        {
+            accelerator.win = true;
+            continue;
+        }
+
+        // 非修饰键只能出现一次
+        if (accelerator.key != 0)
+        {
+            return false;
+        }
+
+        if (part.size() == 1 && std::isalnum(static_cast<unsigned char>(part[0])))
+        {
+            accelerator.key = static_cast<UINT>(std::toupper(static_cast<unsigned char>(part[0])));
+            continue;
+        }
+
+        if (part.size() >= 2 && part[0] == 'f' &&
+            part.find_first_not_of("0123456789", 1) == std::string::npos)
+        {
+            int number = std::atoi(part.c_str() + 1);
+            if (number < 1 || number > 24)
+            {
+                return false;
+            }
+            accelerator.key = VK_F1 + number - 1;
+            continue;
+        }
+
+        for (const auto &named : kNamedKeys)
+        {
+            if (part == named.name)
+            {
+                accelerator.key = named.key;
+                break;
+            }
+        }
+        if (accelerator.key == 0)
+        {
+            return false;
+        }
+    }
+
+    return accelerator.key != 0;
+}
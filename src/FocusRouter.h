@@ -0,0 +1,86 @@
+#ifndef FOCUS_ROUTER_H
+#define FOCUS_ROUTER_H
+
+#include <windows.h>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct FocusEvent
+{
+    enum Type
+    {
+        FocusIn,
+        FocusOut,
+        Accelerator
+    };
+
+    Type type;
+    std::string id;
+    std::string accelerator;
+};
+
+struct AcceleratorKey
+{
+    UINT key;
+    bool ctrl;
+    bool shift;
+    bool alt;
+    bool win;
+    std::string name;
+};
+
+// Tracks which embedded window owns keyboard focus and hands configured
+// accelerators back to the host while focus is inside an embedded app.
+// The hooks live on a dedicated thread with its own message loop, so they
+// keep running while the main thread is blocked (e.g. in
+// CreateEmbeddedWindow). The listener is called on that thread.
+class FocusRouter
+{
+public:
+    using Listener = std::function<void(const FocusEvent &)>;
+
+    static FocusRouter &Instance();
+
+    void SetListener(Listener listener);
+    bool SetAccelerators(const std::vector<std::string> &accelerators, std::string &error);
+    std::string FocusedId() const;
+    void Reset();
+
+    static bool ParseAccelerator(const std::string &text, AcceleratorKey &accelerator);
+
+private:
+    FocusRouter();
+    ~FocusRouter();
+    FocusRouter(const FocusRouter &) = delete;
+    FocusRouter &operator=(const FocusRouter &) = delete;
+
+    void UpdateHooks();
+    void HookThreadMain(std::promise<DWORD> started);
+    void UpdateKeyboardHook();
+    void OnFocusChanged(HWND hwnd);
+    bool OnKeyDown(DWORD vkCode);
+
+    static void CALLBACK WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd,
+                                      LONG idObject, LONG idChild, DWORD eventThread, DWORD eventTime);
+    static LRESULT CALLBACK KeyboardProc(int code, WPARAM wparam, LPARAM lparam);
+
+    // Shared between the caller's thread and the hook thread.
+    mutable std::mutex mutex_;
+    Listener listener_;
+    std::vector<AcceleratorKey> accelerators_;
+    std::string focusedId_;
+
+    // Owned by the thread that sets the listener.
+    std::thread hookThread_;
+    DWORD hookThreadId_;
+
+    // Only touched on the hook thread.
+    HHOOK keyboardHook_;
+    DWORD swallowedKey_;
+};
+
+#endif
@@ -0,0 +1,478 @@
+#include "ProcessSampler.h"
+#include <chrono>
+#include <cstdlib>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#include <tlhelp32.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#endif
+
+namespace
+{
+const unsigned kMinIntervalMs = 50;
+const size_t kMaxHistorySize = 3600;
+
+const char *const kFieldNames[kSampleFieldCount] = {
+    "timestamp",
+    "cpuPercent",
+    "workingSet",
+    "privateBytes",
+    "handleCount",
+    "threadCount",
+    "readBytesPerSec",
+    "writeBytesPerSec",
+};
+}
+
+ProcessSampler &ProcessSampler::Instance()
+{
+    static ProcessSampler instance;
+    return instance;
+}
+
+ProcessSampler::ProcessSampler()
+    : running_(false), intervalMs_(1000), capacity_(60), processorCount_(std::thread::hardware_concurrency())
+{
+    if (processorCount_ == 0)
+    {
+        processorCount_ = 1;
+    }
+}
+
+ProcessSampler::~ProcessSampler()
+{
+    Stop();
+}
+
+ProcessSampler::Entry::Entry(uint32_t pid, size_t capacity)
+    : processId(pid), processHandle(nullptr), hasPrevious(false), previous(), previousTime(0),
+      ring(capacity * kSampleFieldCount, 0.0), head(0), count(0)
+{
+#ifdef _WIN32
+    // 采样线程持有独立句柄，避免与 WindowManager 关闭句柄产生竞争
+    processHandle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_VM_READ, FALSE, pid);
+#endif
+}
+
+ProcessSampler::Entry::~Entry()
+{
+#ifdef _WIN32
+    if (processHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(processHandle));
+    }
+#endif
+}
+
+const char *ProcessSampler::FieldName(int field)
+{
+    if (field < 0 || field >= kSampleFieldCount)
+    {
+        return "";
+    }
+    return kFieldNames[field];
+}
+
+void ProcessSampler::Start(unsigned intervalMs, size_t historySize)
+{
+    Stop();
+
+    if (intervalMs < kMinIntervalMs)
+    {
+        intervalMs = kMinIntervalMs;
+    }
+    if (historySize == 0)
+    {
+        historySize = 1;
+    }
+    if (historySize > kMaxHistorySize)
+    {
+        historySize = kMaxHistorySize;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (historySize != capacity_)
+    {
+        capacity_ = historySize;
+        for (auto &pair : entries_)
+        {
+            Entry &entry = *pair.second;
+            entry.ring.assign(capacity_ * kSampleFieldCount, 0.0);
+            entry.head = 0;
+            entry.count = 0;
+        }
+    }
+    intervalMs_ = intervalMs;
+    running_ = true;
+    worker_ = std::thread(&ProcessSampler::Run, this);
+}
+
+void ProcessSampler::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+}
+
+bool ProcessSampler::IsRunning()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void ProcessSampler::Track(const std::string &id, uint32_t processId)
+{
+    auto entry = std::make_shared<Entry>(processId, 0);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entry->ring.assign(capacity_ * kSampleFieldCount, 0.0);
+    entries_[id] = entry;
+}
+
+void ProcessSampler::Untrack(const std::string &id)
+{
+    std::shared_ptr<Entry> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(id);
+        if (it == entries_.end())
+        {
+            return;
+        }
+        removed = it->second;
+        entries_.erase(it);
+    }
+    // 句柄在最后一个引用释放时关闭（采样线程可能仍持有）
+}
+
+ResourceSnapshot ProcessSampler::Snapshot()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ResourceSnapshot snapshot;
+    snapshot.capacity = capacity_;
+    snapshot.ids.reserve(entries_.size());
+    snapshot.counts.reserve(entries_.size());
+    snapshot.samples.assign(entries_.size() * capacity_ * kSampleFieldCount, 0.0);
+
+    double *out = snapshot.samples.data();
+    for (const auto &pair : entries_)
+    {
+        const Entry &entry = *pair.second;
+        snapshot.ids.push_back(pair.first);
+        snapshot.counts.push_back(static_cast<uint32_t>(entry.count));
+
+        size_t index = (entry.head + capacity_ - entry.count) % capacity_;
+        for (size_t i = 0; i < entry.count; ++i)
+        {
+            const double *row = &entry.ring[index * kSampleFieldCount];
+            for (int f = 0; f < kSampleFieldCount; ++f)
+            {
+                out[i * kSampleFieldCount + f] = row[f];
+            }
+            index = (index + 1) % capacity_;
+        }
+        out += capacity_ * kSampleFieldCount;
+    }
+
+    return snapshot;
+}
+
+void ProcessSampler::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_)
+    {
+        lock.unlock();
+        SampleAll();
+        lock.lock();
+
+        wake_.wait_for(lock, std::chrono::milliseconds(intervalMs_), [this]
+                       { return !running_; });
+    }
+}
+
+void ProcessSampler::Push(Entry &entry, const double *row)
+{
+    size_t capacity = entry.ring.size() / kSampleFieldCount;
+    if (capacity == 0)
+    {
+        return;
+    }
+
+    double *slot = &entry.ring[entry.head * kSampleFieldCount];
+    for (int f = 0; f < kSampleFieldCount; ++f)
+    {
+        slot[f] = row[f];
+    }
+    entry.head = (entry.head + 1) % capacity;
+    if (entry.count < capacity)
+    {
+        ++entry.count;
+    }
+}
+
+void ProcessSampler::SampleAll()
+{
+    std::vector<std::pair<std::string, std::shared_ptr<Entry>>> targets;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        targets.assign(entries_.begin(), entries_.end());
+    }
+
+    if (targets.empty())
+    {
+        return;
+    }
+
+    // 一次快照覆盖所有被跟踪进程的线程数，而不是逐个进程枚举
+    std::map<uint32_t, uint32_t> threadCounts = ReadThreadCounts();
+
+    for (auto &target : targets)
+    {
+        Entry &entry = *target.second;
+
+        RawSample sample = {};
+        if (!ReadProcess(entry, threadCounts, sample))
+        {
+            continue;
+        }
+
+        double now = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now().time_since_epoch())
+                         .count();
+        double timestamp = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(target.first);
+        if (it == entries_.end() || it->second != target.second)
+        {
+            continue;
+        }
+
+        double row[kSampleFieldCount] = {};
+        row[kSampleTimestamp] = timestamp;
+        row[kSampleWorkingSet] = sample.workingSet;
+        row[kSamplePrivateBytes] = sample.privateBytes;
+        row[kSampleHandleCount] = sample.handleCount;
+        row[kSampleThreadCount] = sample.threadCount;
+
+        double elapsed = now - entry.previousTime;
+        if (entry.hasPrevious && elapsed > 0)
+        {
+            double cpu = (sample.cpuSeconds - entry.previous.cpuSeconds) / (elapsed * processorCount_) * 100.0;
+            row[kSampleCpuPercent] = cpu < 0 ? 0 : cpu;
+
+            double read = (sample.readBytes - entry.previous.readBytes) / elapsed;
+            double write = (sample.writeBytes - entry.previous.writeBytes) / elapsed;
+            row[kSampleReadBytesPerSec] = read < 0 ? 0 : read;
+            row[kSampleWriteBytesPerSec] = write < 0 ? 0 : write;
+        }
+
+        entry.previous = sample;
+        entry.previousTime = now;
+        entry.hasPrevious = true;
+        Push(entry, row);
+    }
+}
+
+#ifdef _WIN32
+
+std::map<uint32_t, uint32_t> ProcessSampler::ReadThreadCounts()
+{
+    std::map<uint32_t, uint32_t> counts;
+
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE)
+    {
+        return counts;
+    }
+
+    PROCESSENTRY32W pe = {};
+    pe.dwSize = sizeof(pe);
+    if (Process32FirstW(snapshot, &pe))
+    {
+        do
+        {
+            counts[pe.th32ProcessID] = pe.cntThreads;
+        } while (Process32NextW(snapshot, &pe));
+    }
+
+    CloseHandle(snapshot);
+    return counts;
+}
+
+bool ProcessSampler::ReadProcess(Entry &entry, const std::map<uint32_t, uint32_t> &threadCounts, RawSample &sample)
+{
+    HANDLE process = static_cast<HANDLE>(entry.processHandle);
+    if (!process)
+    {
+        return false;
+    }
+
+    DWORD exitCode = 0;
+    if (!GetExitCodeProcess(process, &exitCode) || exitCode != STILL_ACTIVE)
+    {
+        return false;
+    }
+
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(process, &creationTime, &exitTime, &kernelTime, &userTime))
+    {
+        return false;
+    }
+    ULARGE_INTEGER kernel, user;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    sample.cpuSeconds = static_cast<double>(kernel.QuadPart + user.QuadPart) / 1e7;
+
+    PROCESS_MEMORY_COUNTERS_EX memory = {};
+    memory.cb = sizeof(memory);
+    if (GetProcessMemoryInfo(process, reinterpret_cast<PROCESS_MEMORY_COUNTERS *>(&memory), sizeof(memory)))
+    {
+        sample.workingSet = static_cast<double>(memory.WorkingSetSize);
+        sample.privateBytes = static_cast<double>(memory.PrivateUsage);
+    }
+
+    DWORD handleCount = 0;
+    if (GetProcessHandleCount(process, &handleCount))
+    {
+        sample.handleCount = handleCount;
+    }
+
+    IO_COUNTERS io = {};
+    if (GetProcessIoCounters(process, &io))
+    {
+        sample.readBytes = static_cast<double>(io.ReadTransferCount);
+        sample.writeBytes = static_cast<double>(io.WriteTransferCount);
+    }
+
+    auto it = threadCounts.find(entry.processId);
+    if (it != threadCounts.end())
+    {
+        sample.threadCount = it->second;
+    }
+
+    return true;
+}
+
+#else
+
+std::map<uint32_t, uint32_t> ProcessSampler::ReadThreadCounts()
+{
+    // /proc/<pid>/stat 已包含线程数，无需额外快照
+    return std::map<uint32_t, uint32_t>();
+}
+
+bool ProcessSampler::ReadProcess(Entry &entry, const std::map<uint32_t, uint32_t> &, RawSample &sample)
+{
+    static const double ticksPerSecond = static_cast<double>(sysconf(_SC_CLK_TCK));
+    static const double pageSize = static_cast<double>(sysconf(_SC_PAGESIZE));
+
+    std::string base = "/proc/" + std::to_string(entry.processId);
+
+    std::ifstream stat(base + "/stat");
+    std::string line;
+    if (!std::getline(stat, line))
+    {
+        return false;
+    }
+
+    // comm 字段可能包含空格，从最后一个 ')' 之后开始解析
+    size_t commEnd = line.rfind(')');
+    if (commEnd == std::string::npos)
+    {
+        return false;
+    }
+
+    std::istringstream fields(line.substr(commEnd + 1));
+    std::vector<std::string> tokens;
+    std::string token;
+    while (fields >> token)
+    {
+        tokens.push_back(token);
+    }
+
+    // tokens[0] 为第 3 个字段 (state)
+    if (tokens.size() < 18 || tokens[0] == "Z")
+    {
+        return false;
+    }
+    double utime = std::stod(tokens[11]);
+    double stime = std::stod(tokens[12]);
+    sample.cpuSeconds = (utime + stime) / ticksPerSecond;
+    sample.threadCount = std::stod(tokens[17]);
+
+    std::ifstream statm(base + "/statm");
+    double size = 0, resident = 0;
+    if (statm >> size >> resident)
+    {
+        sample.workingSet = resident * pageSize;
+    }
+
+    // 与 Windows PrivateUsage 对应：匿名常驻页加上已换出的页（status 中单位为 kB）
+    std::ifstream status(base + "/status");
+    std::string statusLine;
+    double privateKb = 0;
+    while (std::getline(status, statusLine))
+    {
+        if (statusLine.compare(0, 8, "RssAnon:") == 0 || statusLine.compare(0, 7, "VmSwap:") == 0)
+        {
+            privateKb += std::strtod(statusLine.c_str() + statusLine.find(':') + 1, nullptr);
+        }
+    }
+    sample.privateBytes = privateKb * 1024;
+
+    DIR *fdDir = opendir((base + "/fd").c_str());
+    if (fdDir)
+    {
+        double count = 0;
+        while (dirent *item = readdir(fdDir))
+        {
+            if (item->d_name[0] != '.')
+            {
+                ++count;
+            }
+        }
+        closedir(fdDir);
+        sample.handleCount = count;
+    }
+
+    std::ifstream io(base + "/io");
+    std::string key;
+    double value = 0;
+    while (io >> key >> value)
+    {
+        if (key == "rchar:")
+        {
+            sample.readBytes = value;
+        }
+        else if (key == "wchar:")
+        {
+            sample.writeBytes = value;
+        }
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef PROCESS_SAMPLER_H
+#define PROCESS_SAMPLER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Column layout of one sample row in ResourceSnapshot::samples.
+enum SampleField
+{
+    kSampleTimestamp = 0,   // ms since epoch
+    kSampleCpuPercent,      // normalized over all cores, 0-100
+    kSampleWorkingSet,      // bytes
+    kSamplePrivateBytes,    // bytes; PrivateUsage (Windows) / RssAnon + VmSwap (Linux)
+    kSampleHandleCount,     // handles (Windows) / open fds (Linux)
+    kSampleThreadCount,
+    kSampleReadBytesPerSec,
+    kSampleWriteBytesPerSec,
+    kSampleFieldCount
+};
+
+struct ResourceSnapshot
+{
+    std::vector<std::string> ids;
+    std::vector<uint32_t> counts;   // valid rows per id, newest row is counts[i] - 1
+    size_t capacity;
+    std::vector<double> samples;    // ids.size() * capacity * kSampleFieldCount, oldest first
+};
+
+class ProcessSampler
+{
+public:
+    static ProcessSampler &Instance();
+
+    void Start(unsigned intervalMs, size_t historySize);
+    void Stop();
+    bool IsRunning();
+
+    void Track(const std::string &id, uint32_t processId);
+    void Untrack(const std::string &id);
+    ResourceSnapshot Snapshot();
+
+    static const char *FieldName(int field);
+
+private:
+    struct RawSample
+    {
+        double cpuSeconds;
+        double workingSet;
+        double privateBytes;
+        double handleCount;
+        double threadCount;
+        double readBytes;
+        double writeBytes;
+    };
+
+    struct Entry
+    {
+        Entry(uint32_t pid, size_t capacity);
+        ~Entry();
+        Entry(const Entry &) = delete;
+        Entry &operator=(const Entry &) = delete;
+
+        uint32_t processId;
+        void *processHandle;
+        bool hasPrevious;
+        RawSample previous;
+        double previousTime;
+        std::vector<double> ring;
+        size_t head;
+        size_t count;
+    };
+
+    ProcessSampler();
+    ~ProcessSampler();
+    ProcessSampler(const ProcessSampler &) = delete;
+    ProcessSampler &operator=(const ProcessSampler &) = delete;
+
+    void Run();
+    void SampleAll();
+    static bool ReadProcess(Entry &entry, const std::map<uint32_t, uint32_t> &threadCounts, RawSample &sample);
+    static std::map<uint32_t, uint32_t> ReadThreadCounts();
+    static void Push(Entry &entry, const double *row);
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::thread worker_;
+    bool running_;
+    unsigned intervalMs_;
+    size_t capacity_;
+    unsigned processorCount_;
+    std::map<std::string, std::shared_ptr<Entry>> entries_;
+};
+
+#endif
@@ -0,0 +1,415 @@
+#include "TraceRecorder.h"
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace
+{
+const char kMagic[4] = {'W', 'M', 'T', 'R'};
+const uint64_t kVersion = 1;
+const size_t kFlushThreshold = 64 * 1024;
+const std::chrono::seconds kFlushInterval(1);
+
+const uint8_t kOpMask = 0x0f;
+const uint8_t kFlagOk = 0x10;
+const uint8_t kFlagShow = 0x20;
+
+// 路径为 UTF-8；Windows 下 fopen 按 ANSI 代码页解释，需转成宽字符再用 _wfopen
+FILE *OpenFile(const std::string &path, const wchar_t *wideMode, const char *mode)
+{
+#ifdef _WIN32
+    (void)mode;
+    int size = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, NULL, 0);
+    if (size <= 0)
+    {
+        return nullptr;
+    }
+    std::wstring widePath(size - 1, 0);
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], size);
+    return _wfopen(widePath.c_str(), wideMode);
+#else
+    (void)wideMode;
+    return fopen(path.c_str(), mode);
+#endif
+}
+
+int64_t SteadyNowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void PutVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void PutSigned(std::string &out, int64_t value)
+{
+    PutVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void PutString(std::string &out, const std::string &value)
+{
+    PutVarint(out, value.size());
+    out.append(value);
+}
+
+// wchar_t 宽度随平台不同，按码元逐个写入，ASCII 路径每个字符只占 1 字节
+void PutWString(std::string &out, const std::wstring &value)
+{
+    PutVarint(out, value.size());
+    for (wchar_t c : value)
+    {
+        PutVarint(out, static_cast<uint64_t>(c));
+    }
+}
+
+class Reader
+{
+public:
+    Reader(const std::string &data) : data_(data), pos_(0) {}
+
+    bool AtEnd() const { return pos_ >= data_.size(); }
+
+    bool Byte(uint8_t &value)
+    {
+        if (pos_ >= data_.size())
+        {
+            return false;
+        }
+        value = static_cast<uint8_t>(data_[pos_++]);
+        return true;
+    }
+
+    bool Varint(uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t byte;
+            if (!Byte(byte))
+            {
+                return false;
+            }
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Signed(int64_t &value)
+    {
+        uint64_t raw;
+        if (!Varint(raw))
+        {
+            return false;
+        }
+        value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+        return true;
+    }
+
+    bool Int(int &value)
+    {
+        int64_t raw;
+        if (!Signed(raw))
+        {
+            return false;
+        }
+        value = static_cast<int>(raw);
+        return true;
+    }
+
+    bool String(std::string &value)
+    {
+        uint64_t size;
+        if (!Varint(size) || size > data_.size() - pos_)
+        {
+            return false;
+        }
+        value.assign(data_, pos_, static_cast<size_t>(size));
+        pos_ += static_cast<size_t>(size);
+        return true;
+    }
+
+    bool WString(std::wstring &value)
+    {
+        uint64_t size;
+        if (!Varint(size) || size > data_.size() - pos_)
+        {
+            return false;
+        }
+        value.clear();
+        value.reserve(static_cast<size_t>(size));
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            uint64_t c;
+            if (!Varint(c))
+            {
+                return false;
+            }
+            value.push_back(static_cast<wchar_t>(c));
+        }
+        return true;
+    }
+
+private:
+    const std::string &data_;
+    size_t pos_;
+};
+}
+
+TraceRecorder &TraceRecorder::Instance()
+{
+    static TraceRecorder instance;
+    return instance;
+}
+
+TraceRecorder::TraceRecorder() : recording_(false), file_(nullptr), lastTimestampUs_(0), originUs_(0), stopping_(false)
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    Stop();
+}
+
+const char *TraceRecorder::OpName(TraceOp op)
+{
+    switch (op)
+    {
+    case TraceCreate:
+        return "create";
+    case TraceUpdate:
+        return "update";
+    case TraceShow:
+        return "show";
+    case TraceDestroy:
+        return "destroy";
+    }
+    return "unknown";
+}
+
+bool TraceRecorder::Start(const std::string &path, std::string &error)
+{
+    Stop();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_ = OpenFile(path, L"wb", "wb");
+    if (!file_)
+    {
+        error = "Failed to open trace file: " + path;
+        return false;
+    }
+
+    buffer_.assign(kMagic, sizeof(kMagic));
+    PutVarint(buffer_, kVersion);
+    Flush();
+    lastTimestampUs_ = 0;
+    stopping_ = false;
+    flusher_ = std::thread(&TraceRecorder::FlushLoop, this);
+    originUs_.store(SteadyNowUs());
+    recording_.store(true);
+    return true;
+}
+
+void TraceRecorder::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        recording_.store(false);
+        stopping_ = true;
+    }
+    flushCondition_.notify_all();
+    if (flusher_.joinable())
+    {
+        flusher_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_)
+    {
+        Flush();
+        fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+void TraceRecorder::FlushLoop()
+{
+    // 录制量通常很小，远填不满缓冲区；按时间落盘，进程崩溃时最多丢失最近 1 秒
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        if (buffer_.empty())
+        {
+            flushCondition_.wait(lock);
+            continue;
+        }
+
+        auto deadline = firstPending_ + kFlushInterval;
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            Flush();
+            continue;
+        }
+        flushCondition_.wait_until(lock, deadline);
+    }
+}
+
+uint64_t TraceRecorder::NowUs() const
+{
+    int64_t elapsed = SteadyNowUs() - originUs_.load();
+    return elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+}
+
+void TraceRecorder::Finish(TraceRecord &record)
+{
+    uint64_t now = NowUs();
+    record.durationUs = now > record.timestampUs ? now - record.timestampUs : 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_)
+    {
+        return;
+    }
+
+    if (buffer_.empty())
+    {
+        firstPending_ = std::chrono::steady_clock::now();
+        flushCondition_.notify_one();
+    }
+
+    uint8_t header = static_cast<uint8_t>(record.op) & kOpMask;
+    if (record.ok)
+    {
+        header |= kFlagOk;
+    }
+    if (record.show)
+    {
+        header |= kFlagShow;
+    }
+    buffer_.push_back(static_cast<char>(header));
+
+    // 多线程下记录按完成顺序写入，开始时间可能回退，因此用有符号差值
+    PutSigned(buffer_, static_cast<int64_t>(record.timestampUs - lastTimestampUs_));
+    lastTimestampUs_ = record.timestampUs;
+    PutVarint(buffer_, record.durationUs);
+    PutString(buffer_, record.id);
+
+    if (record.op == TraceCreate)
+    {
+        PutWString(buffer_, record.exePath);
+        PutWString(buffer_, record.args);
+    }
+    if (record.op == TraceCreate || record.op == TraceUpdate)
+    {
+        PutSigned(buffer_, record.x);
+        PutSigned(buffer_, record.y);
+        PutSigned(buffer_, record.width);
+        PutSigned(buffer_, record.height);
+    }
+
+    if (buffer_.size() >= kFlushThreshold)
+    {
+        Flush();
+    }
+}
+
+void TraceRecorder::Flush()
+{
+    if (file_ && !buffer_.empty())
+    {
+        fwrite(buffer_.data(), 1, buffer_.size(), file_);
+        fflush(file_);
+    }
+    buffer_.clear();
+}
+
+bool TraceRecorder::ReadTrace(const std::string &path, std::vector<TraceRecord> &records, std::string &error)
+{
+    FILE *file = OpenFile(path, L"rb", "rb");
+    if (!file)
+    {
+        error = "Failed to open trace file: " + path;
+        return false;
+    }
+
+    std::string data;
+    char chunk[64 * 1024];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.append(chunk, read);
+    }
+    fclose(file);
+
+    if (data.size() < sizeof(kMagic) || memcmp(data.data(), kMagic, sizeof(kMagic)) != 0)
+    {
+        error = "Not a trace file: " + path;
+        return false;
+    }
+
+    std::string body = data.substr(sizeof(kMagic));
+    Reader reader(body);
+    uint64_t version;
+    if (!reader.Varint(version) || version != kVersion)
+    {
+        error = "Unsupported trace version";
+        return false;
+    }
+
+    records.clear();
+    uint64_t timestamp = 0;
+    while (!reader.AtEnd())
+    {
+        TraceRecord record = {};
+        uint8_t header;
+        int64_t delta;
+        bool ok = reader.Byte(header) && reader.Signed(delta) &&
+                  reader.Varint(record.durationUs) && reader.String(record.id);
+
+        record.op = static_cast<TraceOp>(header & kOpMask);
+        record.ok = (header & kFlagOk) != 0;
+        record.show = (header & kFlagShow) != 0;
+        if (ok && (record.op < TraceCreate || record.op > TraceDestroy))
+        {
+            ok = false;
+        }
+
+        if (ok && record.op == TraceCreate)
+        {
+            ok = reader.WString(record.exePath) && reader.WString(record.args);
+        }
+        if (ok && (record.op == TraceCreate || record.op == TraceUpdate))
+        {
+            ok = reader.Int(record.x) && reader.Int(record.y) &&
+                 reader.Int(record.width) && reader.Int(record.height);
+        }
+
+        if (!ok)
+        {
+            // 录制进程异常退出时末尾记录可能不完整，保留已解析部分
+            error = "Truncated or corrupt record #" + std::to_string(records.size());
+            return !records.empty();
+        }
+
+        timestamp += static_cast<uint64_t>(delta);
+        record.timestampUs = timestamp;
+        records.push_back(record);
+    }
+
+    return true;
+}
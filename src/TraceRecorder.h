@@ -0,0 +1,85 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum TraceOp
+{
+    TraceCreate = 1,
+    TraceUpdate = 2,
+    TraceShow = 3,
+    TraceDestroy = 4
+};
+
+struct TraceRecord
+{
+    TraceOp op;
+    uint64_t timestampUs;   // call start, relative to the start of recording
+    uint64_t durationUs;
+    bool ok;                // create succeeded / call returned true
+    std::string id;         // id returned by create, argument of the others
+    std::wstring exePath;   // create only
+    std::wstring args;      // create only
+    int x, y, width, height; // create / update
+    bool show;              // show only
+};
+
+// Optional recorder for WindowManager calls. Records are appended to a
+// compact binary trace (varint fields, one record per call) that
+// tools/TraceReplay.cc replays against a backend. A background thread writes
+// buffered records to disk at most one second after they were recorded, so a
+// crash or kill loses at most the last second of the trace.
+class TraceRecorder
+{
+public:
+    static TraceRecorder &Instance();
+
+    // Paths are UTF-8 (as passed from JavaScript).
+    bool Start(const std::string &path, std::string &error);
+    void Stop();
+
+    bool IsRecording() const
+    {
+        return recording_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t NowUs() const;
+    // Stamps durationUs from record.timestampUs and appends the record.
+    void Finish(TraceRecord &record);
+
+    // A truncated tail (recorder killed mid-write) keeps the records parsed so
+    // far: returns true with error set. Records still buffered at the time of
+    // the kill (up to one second's worth) are not in the file.
+    static bool ReadTrace(const std::string &path, std::vector<TraceRecord> &records, std::string &error);
+    static const char *OpName(TraceOp op);
+
+private:
+    TraceRecorder();
+    ~TraceRecorder();
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    void Flush();
+    void FlushLoop();
+
+    std::atomic<bool> recording_;
+    std::mutex mutex_;
+    FILE *file_;
+    std::string buffer_;
+    std::chrono::steady_clock::time_point firstPending_; // oldest record in buffer_
+    std::condition_variable flushCondition_;
+    std::thread flusher_;
+    bool stopping_;
+    uint64_t lastTimestampUs_;
+    std::atomic<int64_t> originUs_;
+};
+
+#endif
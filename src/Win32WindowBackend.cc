@@ -0,0 +1,354 @@
+#include "WindowBackend.h"
+#include <windows.h>
+#include <vector>
+
+namespace
+{
+struct EnumWindowsData
+{
+    DWORD processId;
+    HWND targetWindow;
+};
+
+BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam)
+{
+    EnumWindowsData *data = reinterpret_cast<EnumWindowsData *>(lParam);
+    DWORD windowProcessId;
+    GetWindowThreadProcessId(hwnd, &windowProcessId);
+
+    if (windowProcessId == data->processId && IsWindowVisible(hwnd))
+    {
+        wchar_t className[256];
+        GetClassNameW(hwnd, className, 256);
+
+        std::wstring classNameStr(className);
+        if (classNameStr != L"ConsoleWindowClass" &&
+            classNameStr != L"IME" &&
+            GetWindow(hwnd, GW_OWNER) == NULL)
+        {
+            data->targetWindow = hwnd;
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+HWND ToHwnd(NativeWindow window)
+{
+    return static_cast<HWND>(window);
+}
+}
+
+class Win32WindowBackend : public WindowBackend
+{
+public:
+    Win32WindowBackend();
+    ~Win32WindowBackend() override;
+
+    bool IsWindow(NativeWindow window) override;
+    bool FileExists(const std::wstring &path) override;
+    bool PrepareParentWindow(NativeWindow parentWindow) override;
+
+    NativeWindow CreateContainerWindow(NativeWindow parentWindow, int x, int y, int width, int height) override;
+    void DestroyContainerWindow(NativeWindow containerWindow) override;
+
+    bool LaunchProcess(const std::wstring &exePath, const std::wstring &args, LaunchedProcess &process) override;
+    void TerminateProcess(LaunchedProcess &process, unsigned waitMs) override;
+
+    NativeWindow FindAndEmbedWindow(uint32_t processId, NativeWindow containerWindow) override;
+    void MoveEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow, int x, int y, int width, int height) override;
+    void ShowEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow, bool show) override;
+    bool FocusEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow) override;
+
+private:
+    static LRESULT CALLBACK ContainerWndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
+
+    ATOM containerClassAtom_;
+};
+
+std::unique_ptr<WindowBackend> CreatePlatformWindowBackend()
+{
+    return std::unique_ptr<WindowBackend>(new Win32WindowBackend());
+}
+
+Win32WindowBackend::Win32WindowBackend() : containerClassAtom_(0)
+{
+    WNDCLASSEXW wcx = {};
+    wcx.cbSize = sizeof(wcx);
+    wcx.style = CS_HREDRAW | CS_VREDRAW;
+    wcx.hInstance = GetModuleHandle(NULL);
+    wcx.lpfnWndProc = &Win32WindowBackend::ContainerWndProc;
+    wcx.lpszClassName = L"EmbeddedWindowContainer";
+    wcx.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH);
+    wcx.hCursor = LoadCursor(NULL, IDC_ARROW);
+
+    containerClassAtom_ = RegisterClassExW(&wcx);
+}
+
+Win32WindowBackend::~Win32WindowBackend()
+{
+    if (containerClassAtom_)
+    {
+        UnregisterClass(MAKEINTATOM(containerClassAtom_), GetModuleHandle(NULL));
+    }
+}
+
+bool Win32WindowBackend::IsWindow(NativeWindow window)
+{
+    return ::IsWindow(ToHwnd(window)) != FALSE;
+}
+
+bool Win32WindowBackend::FileExists(const std::wstring &path)
+{
+    return GetFileAttributesW(path.c_str()) != INVALID_FILE_ATTRIBUTES;
+}
+
+bool Win32WindowBackend::PrepareParentWindow(NativeWindow parent)
+{
+    HWND parentWindow = ToHwnd(parent);
+    if (!::IsWindow(parentWindow))
+    {
+        return false;
+    }
+
+    HWND hwndD3D = FindWindowEx(parentWindow, NULL, L"Intermediate D3D Window", NULL);
+
+    if (hwndD3D)
+    {
+        LONG_PTR style = GetWindowLongPtr(hwndD3D, GWL_STYLE);
+        if ((style & WS_CLIPSIBLINGS) == 0)
+        {
+            style |= WS_CLIPSIBLINGS;
+            SetWindowLongPtr(hwndD3D, GWL_STYLE, style);
+        }
+    }
+
+    LONG_PTR style = GetWindowLongPtr(parentWindow, GWL_STYLE);
+    if ((style & WS_CLIPCHILDREN) == 0)
+    {
+        style |= WS_CLIPCHILDREN;
+        SetWindowLongPtr(parentWindow, GWL_STYLE, style);
+    }
+
+    return true;
+}
+
+NativeWindow Win32WindowBackend::CreateContainerWindow(NativeWindow parentWindow, int x, int y, int width, int height)
+{
+    if (!containerClassAtom_)
+    {
+        return NULL;
+    }
+
+    DWORD style = WS_CHILD | WS_VISIBLE | WS_CLIPCHILDREN | WS_CLIPSIBLINGS;
+
+    HWND hwnd = CreateWindowExW(
+        0,
+        MAKEINTATOM(containerClassAtom_),
+        L"Container",
+        style,
+        x, y, width, height,
+        ToHwnd(parentWindow),
+        NULL,
+        GetModuleHandle(NULL),
+        NULL);
+
+    return hwnd;
+}
+
+void Win32WindowBackend::DestroyContainerWindow(NativeWindow containerWindow)
+{
+    if (::IsWindow(ToHwnd(containerWindow)))
+    {
+        ::DestroyWindow(ToHwnd(containerWindow));
+    }
+}
+
+bool Win32WindowBackend::LaunchProcess(const std::wstring &exePath, const std::wstring &args, LaunchedProcess &process)
+{
+    STARTUPINFOW si = {};
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESHOWWINDOW;
+    si.wShowWindow = SW_HIDE;
+
+    PROCESS_INFORMATION processInfo;
+    ZeroMemory(&processInfo, sizeof(processInfo));
+
+    std::wstring cmdLine = L"\"" + exePath + L"\"";
+    if (!args.empty())
+    {
+        cmdLine += L" " + args;
+    }
+
+    std::vector<wchar_t> cmdLineBuf(cmdLine.begin(), cmdLine.end());
+    cmdLineBuf.push_back(L'\0');
+
+    BOOL result = CreateProcessW(
+        exePath.c_str(),
+        cmdLineBuf.data(),
+        NULL,
+        NULL,
+        FALSE,
+        CREATE_NEW_CONSOLE,
+        NULL,
+        NULL,
+        &si,
+        &processInfo);
+
+    process.process = processInfo.hProcess;
+    process.thread = processInfo.hThread;
+    process.processId = processInfo.dwProcessId;
+
+    return result != 0;
+}
+
+void Win32WindowBackend::TerminateProcess(LaunchedProcess &process, unsigned waitMs)
+{
+    if (!process.process)
+    {
+        return;
+    }
+
+    ::TerminateProcess(process.process, 0);
+    if (waitMs > 0)
+    {
+        WaitForSingleObject(process.process, waitMs);
+    }
+    CloseHandle(process.process);
+    CloseHandle(process.thread);
+    process.process = NULL;
+    process.thread = NULL;
+}
+
+NativeWindow Win32WindowBackend::FindAndEmbedWindow(uint32_t processId, NativeWindow container)
+{
+    HWND containerWindow = ToHwnd(container);
+    HWND targetWindow = NULL;
+
+    for (int i = 0; i < 50; ++i)
+    {
+        EnumWindowsData data = {processId, NULL};
+        EnumWindows(EnumWindowsProc, reinterpret_cast<LPARAM>(static_cast<void *>(&data)));
+
+        if (data.targetWindow)
+        {
+            targetWindow = data.targetWindow;
+            break;
+        }
+
+        Sleep(100);
+    }
+
+    if (!targetWindow || !::IsWindow(targetWindow))
+    {
+        return NULL;
+    }
+
+    LONG_PTR style = GetWindowLongPtr(targetWindow, GWL_STYLE);
+    style = (style & ~(WS_POPUP | WS_CAPTION | WS_THICKFRAME)) | WS_CHILD;
+    SetWindowLongPtr(targetWindow, GWL_STYLE, style);
+
+    LONG_PTR exStyle = GetWindowLongPtr(targetWindow, GWL_EXSTYLE);
+    exStyle &= ~(WS_EX_DLGMODALFRAME | WS_EX_WINDOWEDGE | WS_EX_CLIENTEDGE | WS_EX_STATICEDGE);
+    SetWindowLongPtr(targetWindow, GWL_EXSTYLE, exStyle);
+
+    SetParent(targetWindow, containerWindow);
+
+    RECT rect;
+    GetClientRect(containerWindow, &rect);
+    SetWindowPos(targetWindow, HWND_TOP, 0, 0,
+                 rect.right - rect.left, rect.bottom - rect.top,
+                 SWP_SHOWWINDOW | SWP_FRAMECHANGED);
+
+    ::ShowWindow(targetWindow, SW_SHOW);
+    ::BringWindowToTop(targetWindow);
+    ::UpdateWindow(targetWindow);
+    ::SetWindowPos(containerWindow, HWND_TOPMOST, 0, 0,
+                   rect.right - rect.left, rect.bottom - rect.top,
+                   SWP_SHOWWINDOW | SWP_FRAMECHANGED);
+
+    // 确保窗口显示
+    ::ShowWindow(containerWindow, SW_SHOW);
+    ::ShowWindow(targetWindow, SW_SHOW);
+    ::UpdateWindow(containerWindow);
+    ::UpdateWindow(targetWindow);
+
+    return targetWindow;
+}
+
+void Win32WindowBackend::MoveEmbeddedWindow(NativeWindow container, NativeWindow target, int x, int y, int width, int height)
+{
+    HWND containerWindow = ToHwnd(container);
+    HWND targetWindow = ToHwnd(target);
+
+    SetWindowPos(containerWindow, NULL, x, y, width, height,
+                 SWP_NOZORDER | SWP_NOACTIVATE);
+
+    if (::IsWindow(targetWindow))
+    {
+        RECT rect;
+        GetClientRect(containerWindow, &rect);
+        SetWindowPos(targetWindow, NULL, 0, 0,
+                     rect.right - rect.left, rect.bottom - rect.top,
+                     SWP_NOZORDER | SWP_NOACTIVATE);
+    }
+}
+
+void Win32WindowBackend::ShowEmbeddedWindow(NativeWindow container, NativeWindow target, bool show)
+{
+    ::ShowWindow(ToHwnd(container), show ? SW_SHOW : SW_HIDE);
+    if (::IsWindow(ToHwnd(target)))
+    {
+        ::ShowWindow(ToHwnd(target), show ? SW_SHOW : SW_HIDE);
+    }
+}
+
+bool Win32WindowBackend::FocusEmbeddedWindow(NativeWindow container, NativeWindow target)
+{
+    HWND targetWindow = ToHwnd(target);
+
+    HWND rootWindow = GetAncestor(ToHwnd(container), GA_ROOT);
+    if (rootWindow && GetForegroundWindow() != rootWindow)
+    {
+        SetForegroundWindow(rootWindow);
+    }
+
+    // 目标窗口属于其他进程的线程，需临时共享输入队列后才能直接设置焦点
+    DWORD currentThread = GetCurrentThreadId();
+    DWORD targetThread = GetWindowThreadProcessId(targetWindow, NULL);
+    bool attached = targetThread != currentThread &&
+                    AttachThreadInput(currentThread, targetThread, TRUE);
+
+    ::SetFocus(targetWindow);
+    HWND focused = ::GetFocus();
+
+    if (attached)
+    {
+        AttachThreadInput(currentThread, targetThread, FALSE);
+    }
+
+    return focused == targetWindow || IsChild(targetWindow, focused);
+}
+
+LRESULT CALLBACK Win32WindowBackend::ContainerWndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
+{
+    switch (msg)
+    {
+    case WM_SIZE:
+    {
+        HWND childWindow = GetWindow(hwnd, GW_CHILD);
+        if (childWindow)
+        {
+            RECT rect;
+            GetClientRect(hwnd, &rect);
+            SetWindowPos(childWindow, NULL, 0, 0,
+                         rect.right - rect.left, rect.bottom - rect.top,
+                         SWP_NOZORDER | SWP_NOACTIVATE);
+        }
+        return 0;
+    }
+    case WM_NCCALCSIZE:
+        return 0;
+    }
+    return DefWindowProcW(hwnd, msg, wparam, lparam);
+}
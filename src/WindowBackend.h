@@ -0,0 +1,46 @@
+#ifndef WINDOW_BACKEND_H
+#define WINDOW_BACKEND_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+typedef void *NativeWindow;
+typedef void *NativeHandle;
+
+struct LaunchedProcess
+{
+    NativeHandle process;
+    NativeHandle thread;
+    uint32_t processId;
+};
+
+// Platform operations used by WindowManager. The Win32 implementation lives in
+// Win32WindowBackend.cc; tools/ provides a fake one so the manager can be
+// exercised on Linux.
+class WindowBackend
+{
+public:
+    virtual ~WindowBackend() {}
+
+    virtual bool IsWindow(NativeWindow window) = 0;
+    virtual bool FileExists(const std::wstring &path) = 0;
+    virtual bool PrepareParentWindow(NativeWindow parentWindow) = 0;
+
+    virtual NativeWindow CreateContainerWindow(NativeWindow parentWindow, int x, int y, int width, int height) = 0;
+    virtual void DestroyContainerWindow(NativeWindow containerWindow) = 0;
+
+    virtual bool LaunchProcess(const std::wstring &exePath, const std::wstring &args, LaunchedProcess &process) = 0;
+    // Terminates the process, waits up to waitMs for it to exit and closes its handles.
+    virtual void TerminateProcess(LaunchedProcess &process, unsigned waitMs) = 0;
+
+    virtual NativeWindow FindAndEmbedWindow(uint32_t processId, NativeWindow containerWindow) = 0;
+    virtual void MoveEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow, int x, int y, int width, int height) = 0;
+    virtual void ShowEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow, bool show) = 0;
+    virtual bool FocusEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow) = 0;
+};
+
+// Defined by whichever backend is linked in.
+std::unique_ptr<WindowBackend> CreatePlatformWindowBackend();
+
+#endif
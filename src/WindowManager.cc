@@ -1,8 +1,8 @@
 #include "WindowManager.h"
+#include "ProcessSampler.h"
+#include "TraceRecorder.h"
 #include <sstream>
 #include <iomanip>
-#include <chrono>
-#include <thread>
 #include <stdexcept>
 
 WindowManager &WindowManager::Instance()
@@ -11,206 +11,85 @@ WindowManager &WindowManager::Instance()
     return instance;
 }
 
-WindowManager::WindowManager() : containerClassAtom_(0), nextId_(1)
+WindowManager::WindowManager() : backend_(CreatePlatformWindowBackend()), nextId_(1)
 {
-    WNDCLASSEXW wcx = {};
-    wcx.cbSize = sizeof(wcx);
-    wcx.style = CS_HREDRAW | CS_VREDRAW;
-    wcx.hInstance = GetModuleHandle(NULL);
-    wcx.lpfnWndProc = &WindowManager::ContainerWndProc;
-    wcx.lpszClassName = L"EmbeddedWindowContainer";
-    wcx.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH);
-    wcx.hCursor = LoadCursor(NULL, IDC_ARROW);
-
-    containerClassAtom_ = RegisterClassExW(&wcx);
+    // 析构时 CleanupAll 会用到这些单例；先构造它们，保证它们在本对象之后析构
+    ProcessSampler::Instance();
+    TraceRecorder::Instance();
 }
 
 WindowManager::~WindowManager()
 {
     CleanupAll();
-    if (containerClassAtom_)
-    {
-        UnregisterClass(MAKEINTATOM(containerClassAtom_), GetModuleHandle(NULL));
-    }
-}
-
-std::string WindowManager::GenerateId()
-{
-    std::ostringstream oss;
-    oss << "embedded_" << std::setfill('0') << std::setw(6) << nextId_++;
-    return oss.str();
 }
 
-bool WindowManager::PrepareParentWindow(HWND parentWindow)
+void WindowManager::SetBackend(std::unique_ptr<WindowBackend> backend)
 {
-    if (!IsWindow(parentWindow))
     {
-        return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        backend_ = std::move(backend);
     }
-
-    HWND hwndD3D = FindWindowEx(parentWindow, NULL, L"Intermediate D3D Window", NULL);
-
-    if (hwndD3D)
-    {
-        LONG_PTR style = GetWindowLongPtr(hwndD3D, GWL_STYLE);
-        if ((style & WS_CLIPSIBLINGS) == 0)
-        {
-            style |= WS_CLIPSIBLINGS;
-            SetWindowLongPtr(hwndD3D, GWL_STYLE, style);
-        }
-    }
-
-    LONG_PTR style = GetWindowLongPtr(parentWindow, GWL_STYLE);
-    if ((style & WS_CLIPCHILDREN) == 0)
-    {
-        style |= WS_CLIPCHILDREN;
-        SetWindowLongPtr(parentWindow, GWL_STYLE, style);
-    }
-
-    return true;
+    CleanupAll();
 }
 
-HWND WindowManager::CreateContainerWindow(HWND parentWindow, int x, int y, int width, int height)
+std::shared_ptr<WindowBackend> WindowManager::Backend()
 {
-    if (!containerClassAtom_)
-    {
-        return NULL;
-    }
-
-    DWORD style = WS_CHILD | WS_VISIBLE | WS_CLIPCHILDREN | WS_CLIPSIBLINGS;
-
-    HWND hwnd = CreateWindowExW(
-        0,
-        MAKEINTATOM(containerClassAtom_),
-        L"Container",
-        style,
-        x, y, width, height,
-        parentWindow,
-        NULL,
-        GetModuleHandle(NULL),
-        NULL);
-
-    return hwnd;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return backend_;
 }
 
-bool WindowManager::LaunchProcess(const std::wstring &exePath, const std::wstring &args, PROCESS_INFORMATION &processInfo)
+std::string WindowManager::GenerateId()
 {
-    STARTUPINFOW si = {};
-    si.cb = sizeof(si);
-    si.dwFlags = STARTF_USESHOWWINDOW;
-    si.wShowWindow = SW_HIDE;
-
-    ZeroMemory(&processInfo, sizeof(processInfo));
-
-    std::wstring cmdLine = L"\"" + exePath + L"\"";
-    if (!args.empty())
-    {
-        cmdLine += L" " + args;
-    }
-
-    std::vector<wchar_t> cmdLineBuf(cmdLine.begin(), cmdLine.end());
-    cmdLineBuf.push_back(L'\0');
-
-    BOOL result = CreateProcessW(
-        exePath.c_str(),
-        cmdLineBuf.data(),
-        NULL,
-        NULL,
-        FALSE,
-        CREATE_NEW_CONSOLE,
-        NULL,
-        NULL,
-        &si,
-        &processInfo);
-
-    return result != 0;
+    std::ostringstream oss;
+    oss << "embedded_" << std::setfill('0') << std::setw(6) << nextId_++;
+    return oss.str();
 }
 
-struct EnumWindowsData
-{
-    DWORD processId;
-    HWND targetWindow;
-};
-
-BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam)
+std::string WindowManager::CreateEmbeddedWindow(
+    NativeWindow parentWindow,
+    const std::wstring &exePath,
+    const std::wstring &args,
+    int x, int y, int width, int height)
 {
-    EnumWindowsData *data = reinterpret_cast<EnumWindowsData *>(lParam);
-    DWORD windowProcessId;
-    GetWindowThreadProcessId(hwnd, &windowProcessId);
-
-    if (windowProcessId == data->processId && IsWindowVisible(hwnd))
+    TraceRecorder &recorder = TraceRecorder::Instance();
+    if (!recorder.IsRecording())
     {
-        wchar_t className[256];
-        GetClassNameW(hwnd, className, 256);
-
-        std::wstring classNameStr(className);
-        if (classNameStr != L"ConsoleWindowClass" &&
-            classNameStr != L"IME" &&
-            GetWindow(hwnd, GW_OWNER) == NULL)
-        {
-            data->targetWindow = hwnd;
-            return FALSE;
-        }
+        return CreateEmbeddedWindowImpl(parentWindow, exePath, args, x, y, width, height);
     }
-    return TRUE;
-}
 
-HWND WindowManager::FindAndEmbedWindow(DWORD processId, HWND containerWindow)
-{
-    HWND targetWindow = NULL;
-
-    for (int i = 0; i < 50; ++i)
+    TraceRecord record = {};
+    record.op = TraceCreate;
+    record.exePath = exePath;
+    record.args = args;
+    record.x = x;
+    record.y = y;
+    record.width = width;
+    record.height = height;
+    record.timestampUs = recorder.NowUs();
+    try
     {
-        EnumWindowsData data = {processId, NULL};
-        EnumWindows(EnumWindowsProc, reinterpret_cast<LPARAM>(static_cast<void *>(&data)));
-
-        if (data.targetWindow)
-        {
-            targetWindow = data.targetWindow;
-            break;
-        }
-
-        Sleep(100);
+        record.id = CreateEmbeddedWindowImpl(parentWindow, exePath, args, x, y, width, height);
+        record.ok = true;
     }
-
-    if (!targetWindow || !IsWindow(targetWindow))
+    catch (...)
     {
-        return NULL;
+        recorder.Finish(record);
+        throw;
     }
-
-    LONG_PTR style = GetWindowLongPtr(targetWindow, GWL_STYLE);
-    style = (style & ~(WS_POPUP | WS_CAPTION | WS_THICKFRAME)) | WS_CHILD;
-    SetWindowLongPtr(targetWindow, GWL_STYLE, style);
-
-    LONG_PTR exStyle = GetWindowLongPtr(targetWindow, GWL_EXSTYLE);
-    exStyle &= ~(WS_EX_DLGMODALFRAME | WS_EX_WINDOWEDGE | WS_EX_CLIENTEDGE | WS_EX_STATICEDGE);
-    SetWindowLongPtr(targetWindow, GWL_EXSTYLE, exStyle);
-
-    SetParent(targetWindow, containerWindow);
-
-    RECT rect;
-    GetClientRect(containerWindow, &rect);
-    SetWindowPos(targetWindow, HWND_TOP, 0, 0,
-                 rect.right - rect.left, rect.bottom - rect.top,
-                 SWP_SHOWWINDOW | SWP_FRAMECHANGED);
-
-    ::ShowWindow(targetWindow, SW_SHOW);
-    ::BringWindowToTop(targetWindow);
-    ::UpdateWindow(targetWindow);
-    ::SetWindowPos(containerWindow, HWND_TOPMOST, 0, 0,
-                   rect.right - rect.left, rect.bottom - rect.top,
-                   SWP_SHOWWINDOW | SWP_FRAMECHANGED);
-
-    return targetWindow;
+    recorder.Finish(record);
+    return record.id;
 }
 
-std::string WindowManager::CreateEmbeddedWindow(
-    HWND parentWindow,
+std::string WindowManager::CreateEmbeddedWindowImpl(
+    NativeWindow parentWindow,
     const std::wstring &exePath,
     const std::wstring &args,
     int x, int y, int width, int height)
 {
-    if (!IsWindow(parentWindow))
+    // 启动进程和查找窗口耗时较长，不持有锁；只有登记到 processes_ 时加锁
+    // 持有 backend 的引用，期间被 SetBackend 替换也不会失效
+    std::shared_ptr<WindowBackend> backend = Backend();
+    if (!backend->IsWindow(parentWindow))
     {
         throw std::runtime_error("Invalid parent window handle");
     }
@@ -220,37 +99,35 @@ std::string WindowManager::CreateEmbeddedWindow(
         throw std::runtime_error("Executable path cannot be empty");
     }
 
-    DWORD fileAttr = GetFileAttributesW(exePath.c_str());
-    if (fileAttr == INVALID_FILE_ATTRIBUTES)
+    if (!backend->FileExists(exePath))
     {
         throw std::runtime_error("Executable file not found");
     }
 
-    if (!PrepareParentWindow(parentWindow))
+    if (!backend->PrepareParentWindow(parentWindow))
     {
         throw std::runtime_error("Failed to prepare parent window");
     }
 
-    HWND containerWindow = CreateContainerWindow(parentWindow, x, y, width, height);
+    NativeWindow containerWindow = backend->CreateContainerWindow(parentWindow, x, y, width, height);
     if (!containerWindow)
     {
         throw std::runtime_error("Failed to create container window");
     }
 
     auto process = std::make_shared<EmbeddedProcess>();
-    if (!LaunchProcess(exePath, args, process->processInfo))
+    process->backend = backend;
+    if (!backend->LaunchProcess(exePath, args, process->processInfo))
     {
-        ::DestroyWindow(containerWindow);
+        backend->DestroyContainerWindow(containerWindow);
         throw std::runtime_error("Failed to launch process");
     }
 
-    HWND targetWindow = FindAndEmbedWindow(process->processInfo.dwProcessId, containerWindow);
+    NativeWindow targetWindow = backend->FindAndEmbedWindow(process->processInfo.processId, containerWindow);
     if (!targetWindow)
     {
-        TerminateProcess(process->processInfo.hProcess, 0);
-        CloseHandle(process->processInfo.hProcess);
-        CloseHandle(process->processInfo.hThread);
-        ::DestroyWindow(containerWindow);
+        backend->TerminateProcess(process->processInfo, 0);
+        backend->DestroyContainerWindow(containerWindow);
         throw std::runtime_error("Failed to find or embed target window");
     }
 
@@ -259,102 +136,159 @@ std::string WindowManager::CreateEmbeddedWindow(
     process->processPath = exePath;
     process->arguments = args;
     process->isRunning = true;
-    process->processId = process->processInfo.dwProcessId;
-
-    // 确保窗口显示
-    ::ShowWindow(containerWindow, SW_SHOW);
-    ::ShowWindow(targetWindow, SW_SHOW);
-    ::UpdateWindow(containerWindow);
-    ::UpdateWindow(targetWindow);
+    process->processId = process->processInfo.processId;
 
+    std::lock_guard<std::mutex> lock(mutex_);
     std::string id = GenerateId();
     processes_[id] = process;
+    ProcessSampler::Instance().Track(id, process->processId);
 
     return id;
 }
 
 bool WindowManager::UpdateWindow(const std::string &id, int x, int y, int width, int height)
 {
-    auto it = processes_.find(id);
-    if (it == processes_.end())
+    TraceRecorder &recorder = TraceRecorder::Instance();
+    if (!recorder.IsRecording())
     {
-        return false;
+        return UpdateWindowImpl(id, x, y, width, height);
     }
 
-    auto &process = it->second;
-    if (!process->isRunning || !IsWindow(process->embedWindow))
+    TraceRecord record = {};
+    record.op = TraceUpdate;
+    record.id = id;
+    record.x = x;
+    record.y = y;
+    record.width = width;
+    record.height = height;
+    record.timestampUs = recorder.NowUs();
+    record.ok = UpdateWindowImpl(id, x, y, width, height);
+    recorder.Finish(record);
+    return record.ok;
+}
+
+bool WindowManager::UpdateWindowImpl(const std::string &id, int x, int y, int width, int height)
+{
+    auto process = FindRunningProcess(id);
+    if (!process || !process->backend->IsWindow(process->embedWindow))
     {
         return false;
     }
 
-    SetWindowPos(process->embedWindow, NULL, x, y, width, height,
-                 SWP_NOZORDER | SWP_NOACTIVATE);
+    process->backend->MoveEmbeddedWindow(process->embedWindow, process->targetWindow, x, y, width, height);
+    return true;
+}
 
-    if (IsWindow(process->targetWindow))
+bool WindowManager::ShowWindow(const std::string &id, bool show)
+{
+    TraceRecorder &recorder = TraceRecorder::Instance();
+    if (!recorder.IsRecording())
     {
-        RECT rect;
-        GetClientRect(process->embedWindow, &rect);
-        SetWindowPos(process->targetWindow, NULL, 0, 0,
-                     rect.right - rect.left, rect.bottom - rect.top,
-                     SWP_NOZORDER | SWP_NOACTIVATE);
+        return ShowWindowImpl(id, show);
     }
 
-    return true;
+    TraceRecord record = {};
+    record.op = TraceShow;
+    record.id = id;
+    record.show = show;
+    record.timestampUs = recorder.NowUs();
+    record.ok = ShowWindowImpl(id, show);
+    recorder.Finish(record);
+    return record.ok;
 }
 
-bool WindowManager::ShowWindow(const std::string &id, bool show)
+bool WindowManager::ShowWindowImpl(const std::string &id, bool show)
 {
-    auto it = processes_.find(id);
-    if (it == processes_.end())
+    auto process = FindRunningProcess(id);
+    if (!process || !process->backend->IsWindow(process->embedWindow))
     {
         return false;
     }
 
-    auto &process = it->second;
-    if (!IsWindow(process->embedWindow))
+    process->backend->ShowEmbeddedWindow(process->embedWindow, process->targetWindow, show);
+    return true;
+}
+
+bool WindowManager::FocusWindow(const std::string &id)
+{
+    auto process = FindRunningProcess(id);
+    if (!process || !process->backend->IsWindow(process->targetWindow))
     {
         return false;
     }
 
-    ::ShowWindow(process->embedWindow, show ? SW_SHOW : SW_HIDE);
-    if (IsWindow(process->targetWindow))
+    return process->backend->FocusEmbeddedWindow(process->embedWindow, process->targetWindow);
+}
+
+std::shared_ptr<EmbeddedProcess> WindowManager::FindRunningProcess(const std::string &id)
+{
+    // 只在查表时持锁：SetWindowPos、SetFocus 等跨线程调用在等待时会处理传入的消息和
+    // WinEvent 回调，焦点钩子会重入 FindIdByContainer，持锁调用会自锁
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = processes_.find(id);
+    if (it == processes_.end() || !it->second->isRunning)
     {
-        ::ShowWindow(process->targetWindow, show ? SW_SHOW : SW_HIDE);
+        return nullptr;
     }
+    return it->second;
+}
 
-    return true;
+std::string WindowManager::FindIdByContainer(NativeWindow containerWindow)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &pair : processes_)
+    {
+        if (pair.second->embedWindow == containerWindow)
+        {
+            return pair.first;
+        }
+    }
+    return "";
 }
 
 bool WindowManager::DestroyWindow(const std::string &id)
 {
-    auto it = processes_.find(id);
-    if (it == processes_.end())
+    TraceRecorder &recorder = TraceRecorder::Instance();
+    if (!recorder.IsRecording())
     {
-        return false;
+        return DestroyWindowImpl(id);
     }
 
-    auto process = it->second;
-    process->isRunning = false;
+    TraceRecord record = {};
+    record.op = TraceDestroy;
+    record.id = id;
+    record.timestampUs = recorder.NowUs();
+    record.ok = DestroyWindowImpl(id);
+    recorder.Finish(record);
+    return record.ok;
+}
 
-    if (process->processInfo.hProcess)
+bool WindowManager::DestroyWindowImpl(const std::string &id)
+{
+    std::shared_ptr<EmbeddedProcess> process;
     {
-        TerminateProcess(process->processInfo.hProcess, 0);
-        WaitForSingleObject(process->processInfo.hProcess, 2000);
-        CloseHandle(process->processInfo.hProcess);
-        CloseHandle(process->processInfo.hThread);
-    }
+        // 先从表中移除，之后的终止进程和销毁窗口由当前线程独占执行
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = processes_.find(id);
+        if (it == processes_.end())
+        {
+            return false;
+        }
 
-    if (IsWindow(process->embedWindow))
-    {
-        ::DestroyWindow(process->embedWindow);
+        process = it->second;
+        process->isRunning = false;
+        processes_.erase(it);
+        ProcessSampler::Instance().Untrack(id);
     }
 
-    processes_.erase(it);
+    process->backend->TerminateProcess(process->processInfo, 2000);
+    process->backend->DestroyContainerWindow(process->embedWindow);
     return true;
 }
 
 std::vector<std::string> WindowManager::GetAllWindowIds()
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     std::vector<std::string> ids;
     for (const auto &pair : processes_)
     {
@@ -371,26 +305,3 @@ void WindowManager::CleanupAll()
         DestroyWindow(id);
     }
 }
-
-LRESULT CALLBACK WindowManager::ContainerWndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
-{
-    switch (msg)
-    {
-    case WM_SIZE:
-    {
-        HWND childWindow = GetWindow(hwnd, GW_CHILD);
-        if (childWindow)
-        {
-            RECT rect;
-            GetClientRect(hwnd, &rect);
-            SetWindowPos(childWindow, NULL, 0, 0,
-                         rect.right - rect.left, rect.bottom - rect.top,
-                         SWP_NOZORDER | SWP_NOACTIVATE);
-        }
-        return 0;
-    }
-    case WM_NCCALCSIZE:
-        return 0;
-    }
-    return DefWindowProcW(hwnd, msg, wparam, lparam);
-}
\ No newline at end of file
@@ -1,21 +1,24 @@
 #ifndef WINDOW_MANAGER_H
 #define WINDOW_MANAGER_H
 
-#include <windows.h>
+#include "WindowBackend.h"
 #include <string>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 struct EmbeddedProcess
 {
-    PROCESS_INFORMATION processInfo;
-    HWND embedWindow;
-    HWND targetWindow;
+    // Backend that created the window; it is also used to tear it down.
+    std::shared_ptr<WindowBackend> backend;
+    LaunchedProcess processInfo;
+    NativeWindow embedWindow;
+    NativeWindow targetWindow;
     std::wstring processPath;
     std::wstring arguments;
     bool isRunning;
-    DWORD processId;
+    uint32_t processId;
 };
 
 class WindowManager
@@ -24,7 +27,7 @@ public:
     static WindowManager &Instance();
 
     std::string CreateEmbeddedWindow(
-        HWND parentWindow,
+        NativeWindow parentWindow,
         const std::wstring &exePath,
         const std::wstring &args,
         int x, int y, int width, int height);
@@ -32,26 +35,38 @@ public:
     bool UpdateWindow(const std::string &id, int x, int y, int width, int height);
     bool DestroyWindow(const std::string &id);
     bool ShowWindow(const std::string &id, bool show);
+    bool FocusWindow(const std::string &id);
+    std::string FindIdByContainer(NativeWindow containerWindow);
     std::vector<std::string> GetAllWindowIds();
     void CleanupAll();
 
+    // Swaps in another backend (used by tools/), then destroys every embedded
+    // window through the backend that created it. Calls already in flight
+    // keep their own reference to the previous backend.
+    void SetBackend(std::unique_ptr<WindowBackend> backend);
+
 private:
     WindowManager();
     ~WindowManager();
     WindowManager(const WindowManager &) = delete;
     WindowManager &operator=(const WindowManager &) = delete;
 
-    bool PrepareParentWindow(HWND parentWindow);
-    HWND CreateContainerWindow(HWND parentWindow, int x, int y, int width, int height);
-    bool LaunchProcess(const std::wstring &exePath, const std::wstring &args, PROCESS_INFORMATION &processInfo);
-    HWND FindAndEmbedWindow(DWORD processId, HWND containerWindow);
+    std::string CreateEmbeddedWindowImpl(
+        NativeWindow parentWindow,
+        const std::wstring &exePath,
+        const std::wstring &args,
+        int x, int y, int width, int height);
+    bool UpdateWindowImpl(const std::string &id, int x, int y, int width, int height);
+    bool DestroyWindowImpl(const std::string &id);
+    bool ShowWindowImpl(const std::string &id, bool show);
+    std::shared_ptr<EmbeddedProcess> FindRunningProcess(const std::string &id);
+    std::shared_ptr<WindowBackend> Backend();
     std::string GenerateId();
 
-    static LRESULT CALLBACK ContainerWndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
-
+    std::shared_ptr<WindowBackend> backend_;
+    std::mutex mutex_;
     std::map<std::string, std::shared_ptr<EmbeddedProcess>> processes_;
-    ATOM containerClassAtom_;
     int nextId_;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,5 +1,10 @@
 #include <napi.h>
+#include <windows.h>
 #include "WindowManager.h"
+#include "ProcessSampler.h"
+#include "FocusRouter.h"
+#include "TraceRecorder.h"
+#include <cstring>
 
 std::wstring ToWString(const Napi::Value &value)
 {
@@ -95,7 +100,7 @@ Napi::Value CreateEmbeddedWindow(const Napi::CallbackInfo &info)
         }
 
         std::string id = WindowManager::Instance().CreateEmbeddedWindow(
-            hwndParent, exePath, args, x, y, width, height);
+            static_cast<NativeWindow>(hwndParent), exePath, args, x, y, width, height);
 
         return Napi::String::New(env, id);
     }
@@ -258,6 +263,289 @@ Napi::Value CleanupAll(const Napi::CallbackInfo &info)
     }
 }
 
+Napi::Value FocusWindow(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    try
+    {
+        if (info.Length() < 1 || !info[0].IsString())
+        {
+            Napi::TypeError::New(env, "Argument 0 must be a string (window id)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string id = info[0].As<Napi::String>().Utf8Value();
+        bool result = WindowManager::Instance().FocusWindow(id);
+        return Napi::Boolean::New(env, result);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+static Napi::ThreadSafeFunction focusListener;
+
+void CallFocusListener(Napi::Env env, Napi::Function callback, FocusEvent *event)
+{
+    const char *type = "accelerator";
+    if (event->type == FocusEvent::FocusIn)
+    {
+        type = "focusin";
+    }
+    else if (event->type == FocusEvent::FocusOut)
+    {
+        type = "focusout";
+    }
+
+    Napi::Object payload = Napi::Object::New(env);
+    payload.Set("type", Napi::String::New(env, type));
+    payload.Set("id", Napi::String::New(env, event->id));
+    if (event->type == FocusEvent::Accelerator)
+    {
+        payload.Set("accelerator", Napi::String::New(env, event->accelerator));
+    }
+    delete event;
+
+    callback.Call({payload});
+}
+
+void PostFocusEvent(const FocusEvent &event)
+{
+    FocusEvent *data = new FocusEvent(event);
+    if (focusListener.NonBlockingCall(data, CallFocusListener) != napi_ok)
+    {
+        delete data;
+    }
+}
+
+// 回调参数: { type: "focusin" | "focusout" | "accelerator", id, accelerator? }
+Napi::Value SetFocusListener(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    try
+    {
+        bool clear = info.Length() < 1 || info[0].IsNull() || info[0].IsUndefined();
+        if (!clear && !info[0].IsFunction())
+        {
+            Napi::TypeError::New(env, "Argument 0 must be a function or null").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        // 先解除旧监听再释放，避免钩子回调使用已释放的 tsfn
+        FocusRouter::Instance().SetListener(nullptr);
+        if (focusListener)
+        {
+            focusListener.Release();
+            focusListener = Napi::ThreadSafeFunction();
+        }
+
+        if (clear)
+        {
+            return env.Undefined();
+        }
+
+        focusListener = Napi::ThreadSafeFunction::New(env, info[0].As<Napi::Function>(), "FocusListener", 0, 1);
+        focusListener.Unref(env);
+
+        FocusRouter::Instance().SetListener(PostFocusEvent);
+
+        return env.Undefined();
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value SetAcceleratorPassthrough(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    try
+    {
+        if (info.Length() < 1 || !info[0].IsArray())
+        {
+            Napi::TypeError::New(env, "Argument 0 must be an array of accelerators").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        Napi::Array list = info[0].As<Napi::Array>();
+        std::vector<std::string> accelerators;
+        for (uint32_t i = 0; i < list.Length(); ++i)
+        {
+            Napi::Maybe<Napi::Value> itemMaybe = list.Get(i);
+            if (itemMaybe.IsNothing() || !itemMaybe.Unwrap().IsString())
+            {
+                Napi::TypeError::New(env, "Accelerators must be strings").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            accelerators.push_back(itemMaybe.Unwrap().As<Napi::String>().Utf8Value());
+        }
+
+        std::string error;
+        if (!FocusRouter::Instance().SetAccelerators(accelerators, error))
+        {
+            Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        return env.Undefined();
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value StartTraceRecording(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    try
+    {
+        if (info.Length() < 1 || !info[0].IsString())
+        {
+            Napi::TypeError::New(env, "Argument 0 must be a string (trace file path)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string error;
+        if (!TraceRecorder::Instance().Start(info[0].As<Napi::String>().Utf8Value(), error))
+        {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        return env.Undefined();
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value StopTraceRecording(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    try
+    {
+        TraceRecorder::Instance().Stop();
+        return env.Undefined();
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value StartResourceSampler(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    try
+    {
+        unsigned intervalMs = 1000;
+        size_t historySize = 60;
+
+        if (info.Length() > 0 && info[0].IsObject())
+        {
+            Napi::Object options = info[0].As<Napi::Object>();
+
+            Napi::Maybe<Napi::Value> intervalMaybe = options.Get("intervalMs");
+            if (!intervalMaybe.IsNothing() && intervalMaybe.Unwrap().IsNumber())
+            {
+                intervalMs = intervalMaybe.Unwrap().As<Napi::Number>().Uint32Value();
+            }
+
+            Napi::Maybe<Napi::Value> historyMaybe = options.Get("historySize");
+            if (!historyMaybe.IsNothing() && historyMaybe.Unwrap().IsNumber())
+            {
+                historySize = historyMaybe.Unwrap().As<Napi::Number>().Uint32Value();
+            }
+        }
+
+        ProcessSampler::Instance().Start(intervalMs, historySize);
+        return env.Undefined();
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value StopResourceSampler(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    try
+    {
+        ProcessSampler::Instance().Stop();
+        return env.Undefined();
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+// 返回 { ids, fields, capacity, counts, samples }
+// samples 为 Float64Array，按 [id][历史行][字段] 排列，每个 id 的行从旧到新
+Napi::Value GetResourceSnapshot(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    try
+    {
+        ResourceSnapshot snapshot = ProcessSampler::Instance().Snapshot();
+
+        Napi::Array ids = Napi::Array::New(env, snapshot.ids.size());
+        for (size_t i = 0; i < snapshot.ids.size(); ++i)
+        {
+            ids[i] = Napi::String::New(env, snapshot.ids[i]);
+        }
+
+        Napi::Array fields = Napi::Array::New(env, kSampleFieldCount);
+        for (int f = 0; f < kSampleFieldCount; ++f)
+        {
+            fields[f] = Napi::String::New(env, ProcessSampler::FieldName(f));
+        }
+
+        Napi::Uint32Array counts = Napi::Uint32Array::New(env, snapshot.counts.size());
+        for (size_t i = 0; i < snapshot.counts.size(); ++i)
+        {
+            counts[i] = snapshot.counts[i];
+        }
+
+        Napi::Float64Array samples = Napi::Float64Array::New(env, snapshot.samples.size());
+        if (!snapshot.samples.empty())
+        {
+            memcpy(samples.Data(), snapshot.samples.data(), snapshot.samples.size() * sizeof(double));
+        }
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("ids", ids);
+        result.Set("fields", fields);
+        result.Set("capacity", Napi::Number::New(env, static_cast<double>(snapshot.capacity)));
+        result.Set("counts", counts);
+        result.Set("samples", samples);
+        return result;
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
 Napi::Object Init(Napi::Env env, Napi::Object exports)
 {
     // 使用 lambda 函数包装
@@ -291,6 +579,46 @@ Napi::Object Init(Napi::Env env, Napi::Object exports)
         Napi::Function::New(env, [](const Napi::CallbackInfo &info)
                             { return CleanupAll(info); }));
 
+    exports.Set(
+        Napi::String::New(env, "focusWindow"),
+        Napi::Function::New(env, [](const Napi::CallbackInfo &info)
+                            { return FocusWindow(info); }));
+
+    exports.Set(
+        Napi::String::New(env, "setFocusListener"),
+        Napi::Function::New(env, [](const Napi::CallbackInfo &info)
+                            { return SetFocusListener(info); }));
+
+    exports.Set(
+        Napi::String::New(env, "setAcceleratorPassthrough"),
+        Napi::Function::New(env, [](const Napi::CallbackInfo &info)
+                            { return SetAcceleratorPassthrough(info); }));
+
+    exports.Set(
+        Napi::String::New(env, "startTraceRecording"),
+        Napi::Function::New(env, [](const Napi::CallbackInfo &info)
+                            { return StartTraceRecording(info); }));
+
+    exports.Set(
+        Napi::String::New(env, "stopTraceRecording"),
+        Napi::Function::New(env, [](const Napi::CallbackInfo &info)
+                            { return StopTraceRecording(info); }));
+
+    exports.Set(
+        Napi::String::New(env, "startResourceSampler"),
+        Napi::Function::New(env, [](const Napi::CallbackInfo &info)
+                            { return StartResourceSampler(info); }));
+
+    exports.Set(
+        Napi::String::New(env, "stopResourceSampler"),
+        Napi::Function::New(env, [](const Napi::CallbackInfo &info)
+                            { return StopResourceSampler(info); }));
+
+    exports.Set(
+        Napi::String::New(env, "getResourceSnapshot"),
+        Napi::Function::New(env, [](const Napi::CallbackInfo &info)
+                            { return GetResourceSnapshot(info); }));
+
     return exports;
 }
 NODE_API_MODULE(BrowserWindowTool, Init)
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "FakeWindowBackend.h"
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+namespace
+{
+const uintptr_t kThreadTokenBase = uintptr_t(1) << 20;
+
+NativeWindow ToNative(uintptr_t window)
+{
+    return reinterpret_cast<NativeWindow>(window);
+}
+
+uintptr_t FromNative(NativeWindow window)
+{
+    return reinterpret_cast<uintptr_t>(window);
+}
+
+int OpenPidFd(pid_t pid)
+{
+#ifdef SYS_pidfd_open
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+}
+
+std::unique_ptr<WindowBackend> CreatePlatformWindowBackend()
+{
+    return std::unique_ptr<WindowBackend>(new FakeWindowBackend(FakeWindowBackend::DefaultOptions()));
+}
+
+FakeWindowBackend::Options FakeWindowBackend::DefaultOptions()
+{
+    Options options;
+    options.command = {"/bin/sleep", "3600"};
+    options.containerFailRate = 0;
+    options.launchFailRate = 0;
+    options.embedFailRate = 0;
+    options.embedDelayUs = 0;
+    return options;
+}
+
+FakeWindowBackend::FakeWindowBackend(const Options &options)
+    : options_(options), nextWindow_(0x1000), nextHandle_(kThreadTokenBase)
+{
+}
+
+FakeWindowBackend::~FakeWindowBackend()
+{
+    // 兜底回收，避免测试异常退出时留下子进程
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int pid : children_)
+    {
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+    }
+}
+
+bool FakeWindowBackend::Roll(double rate)
+{
+    if (rate <= 0)
+    {
+        return false;
+    }
+    thread_local std::mt19937 engine(std::random_device{}());
+    return std::uniform_real_distribution<double>(0, 1)(engine) < rate;
+}
+
+uintptr_t FakeWindowBackend::AddWindow(uintptr_t parent, int x, int y, int width, int height)
+{
+    uintptr_t window = nextWindow_;
+    nextWindow_ += 0x10;
+    windows_[window] = FakeWindow{parent, x, y, width, height, true};
+    return window;
+}
+
+NativeWindow FakeWindowBackend::CreateHostWindow()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ToNative(AddWindow(0, 0, 0, 1200, 700));
+}
+
+void FakeWindowBackend::DestroyHostWindow(NativeWindow window)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    windows_.erase(FromNative(window));
+}
+
+FakeWindowBackend::Stats FakeWindowBackend::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return Stats{windows_.size(), children_.size(), handles_.size()};
+}
+
+bool FakeWindowBackend::IsWindow(NativeWindow window)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return windows_.count(FromNative(window)) != 0;
+}
+
+bool FakeWindowBackend::FileExists(const std::wstring &path)
+{
+    return !path.empty();
+}
+
+bool FakeWindowBackend::PrepareParentWindow(NativeWindow parentWindow)
+{
+    return IsWindow(parentWindow);
+}
+
+NativeWindow FakeWindowBackend::CreateContainerWindow(NativeWindow parentWindow, int x, int y, int width, int height)
+{
+    if (Roll(options_.containerFailRate))
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (windows_.count(FromNative(parentWindow)) == 0)
+    {
+        return nullptr;
+    }
+    return ToNative(AddWindow(FromNative(parentWindow), x, y, width, height));
+}
+
+void FakeWindowBackend::DestroyContainerWindow(NativeWindow containerWindow)
+{
+    uintptr_t container = FromNative(containerWindow);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = windows_.begin(); it != windows_.end();)
+    {
+        if (it->first == container || it->second.parent == container)
+        {
+            it = windows_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool FakeWindowBackend::LaunchProcess(const std::wstring &, const std::wstring &, LaunchedProcess &process)
+{
+    process = LaunchedProcess{nullptr, nullptr, 0};
+    if (Roll(options_.launchFailRate) || options_.command.empty())
+    {
+        return false;
+    }
+
+    std::vector<char *> argv;
+    for (auto &arg : options_.command)
+    {
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid = 0;
+    if (posix_spawn(&pid, argv[0], NULL, NULL, argv.data(), environ) != 0)
+    {
+        return false;
+    }
+
+    int pidFd = OpenPidFd(pid);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    children_.insert(pid);
+
+    // 进程句柄用 pidfd 表示（+1 以避开空指针），拿不到时退化为计数令牌
+    uintptr_t processToken = pidFd >= 0 ? static_cast<uintptr_t>(pidFd) + 1 : nextHandle_++;
+    uintptr_t threadToken = nextHandle_++;
+    handles_.insert(processToken);
+    handles_.insert(threadToken);
+
+    process.process = reinterpret_cast<NativeHandle>(processToken);
+    process.thread = reinterpret_cast<NativeHandle>(threadToken);
+    process.processId = static_cast<uint32_t>(pid);
+    return true;
+}
+
+void FakeWindowBackend::TerminateProcess(LaunchedProcess &process, unsigned)
+{
+    if (!process.process)
+    {
+        return;
+    }
+
+    pid_t pid = static_cast<pid_t>(process.processId);
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+
+    uintptr_t processToken = reinterpret_cast<uintptr_t>(process.process);
+
+    // 关闭 pidfd 与移出表需原子完成，否则复用的 fd 号会被其他线程重复登记
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (processToken < kThreadTokenBase)
+    {
+        close(static_cast<int>(processToken - 1));
+    }
+    children_.erase(pid);
+    handles_.erase(processToken);
+    handles_.erase(reinterpret_cast<uintptr_t>(process.thread));
+    process.process = nullptr;
+    process.thread = nullptr;
+}
+
+NativeWindow FakeWindowBackend::FindAndEmbedWindow(uint32_t, NativeWindow containerWindow)
+{
+    if (options_.embedDelayUs > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(options_.embedDelayUs));
+    }
+    if (Roll(options_.embedFailRate))
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = windows_.find(FromNative(containerWindow));
+    if (it == windows_.end())
+    {
+        return nullptr;
+    }
+    FakeWindow container = it->second;
+    return ToNative(AddWindow(it->first, 0, 0, container.width, container.height));
+}
+
+void FakeWindowBackend::MoveEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow, int x, int y, int width, int height)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto container = windows_.find(FromNative(containerWindow));
+    if (container == windows_.end())
+    {
+        return;
+    }
+    container->second.x = x;
+    container->second.y = y;
+    container->second.width = width;
+    container->second.height = height;
+
+    auto target = windows_.find(FromNative(targetWindow));
+    if (target != windows_.end())
+    {
+        target->second.width = width;
+        target->second.height = height;
+    }
+}
+
+void FakeWindowBackend::ShowEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow, bool show)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uintptr_t window : {FromNative(containerWindow), FromNative(targetWindow)})
+    {
+        auto it = windows_.find(window);
+        if (it != windows_.end())
+        {
+            it->second.visible = show;
+        }
+    }
+}
+
+bool FakeWindowBackend::FocusEmbeddedWindow(NativeWindow, NativeWindow targetWindow)
+{
+    return IsWindow(targetWindow);
+}
@@ -0,0 +1,79 @@
+#ifndef FAKE_WINDOW_BACKEND_H
+#define FAKE_WINDOW_BACKEND_H
+
+#include "WindowBackend.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// In-memory window backend for Linux. Windows are opaque tokens tracked in a
+// table; every launched process is a real child started from `command`, so
+// process and fd leaks are real leaks. Failure rates exercise the early-exit
+// cleanup paths of WindowManager::CreateEmbeddedWindow.
+class FakeWindowBackend : public WindowBackend
+{
+public:
+    struct Options
+    {
+        std::vector<std::string> command;
+        double containerFailRate;
+        double launchFailRate;
+        double embedFailRate;
+        unsigned embedDelayUs;
+    };
+
+    struct Stats
+    {
+        size_t liveWindows;      // host + container + target windows
+        size_t liveProcesses;    // children not reaped yet
+        size_t openHandles;      // pidfds + thread tokens not closed yet
+    };
+
+    static Options DefaultOptions();
+
+    explicit FakeWindowBackend(const Options &options);
+    ~FakeWindowBackend() override;
+
+    NativeWindow CreateHostWindow();
+    void DestroyHostWindow(NativeWindow window);
+    Stats GetStats();
+
+    bool IsWindow(NativeWindow window) override;
+    bool FileExists(const std::wstring &path) override;
+    bool PrepareParentWindow(NativeWindow parentWindow) override;
+
+    NativeWindow CreateContainerWindow(NativeWindow parentWindow, int x, int y, int width, int height) override;
+    void DestroyContainerWindow(NativeWindow containerWindow) override;
+
+    bool LaunchProcess(const std::wstring &exePath, const std::wstring &args, LaunchedProcess &process) override;
+    void TerminateProcess(LaunchedProcess &process, unsigned waitMs) override;
+
+    NativeWindow FindAndEmbedWindow(uint32_t processId, NativeWindow containerWindow) override;
+    void MoveEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow, int x, int y, int width, int height) override;
+    void ShowEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow, bool show) override;
+    bool FocusEmbeddedWindow(NativeWindow containerWindow, NativeWindow targetWindow) override;
+
+private:
+    struct FakeWindow
+    {
+        uintptr_t parent;
+        int x, y, width, height;
+        bool visible;
+    };
+
+    uintptr_t AddWindow(uintptr_t parent, int x, int y, int width, int height);
+    static bool Roll(double rate);
+
+    Options options_;
+    std::mutex mutex_;
+    std::map<uintptr_t, FakeWindow> windows_;
+    std::set<uintptr_t> handles_;
+    std::set<int> children_;
+    uintptr_t nextWindow_;
+    uintptr_t nextHandle_;
+};
+
+#endif
@@ -0,0 +1,336 @@
+// Concurrency stress and leak-soak harness for WindowManager.
+//
+// Drives create/update/show/focus/destroy/cleanupAll from several threads
+// against FakeWindowBackend (real child processes, fake windows), prints
+// throughput periodically and exits non-zero if any process, handle, fd,
+// window or registry entry is left behind at the end.
+//
+//   wm_stress [--threads N] [--duration SEC] [--max-windows N]
+//             [--fail-rate P] [--embed-delay-us US] [--sample-ms MS]
+//             [--report-every SEC] [--trace FILE] [-- command args...]
+
+#include "FakeWindowBackend.h"
+#include "ProcessSampler.h"
+#include "TraceRecorder.h"
+#include "WindowManager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+#include <dirent.h>
+#include <sys/wait.h>
+
+namespace
+{
+struct Config
+{
+    unsigned threads = 8;
+    double durationSec = 10;
+    size_t maxWindows = 32;
+    double failRate = 0.05;
+    unsigned embedDelayUs = 200;
+    unsigned sampleMs = 100;
+    double reportEverySec = 5;
+    std::string tracePath;
+    std::vector<std::string> command;
+};
+
+enum Op
+{
+    OpCreate,
+    OpCreateFailed,
+    OpUpdate,
+    OpShow,
+    OpFocus,
+    OpDestroy,
+    OpCleanupAll,
+    OpMiss,
+    OpCount
+};
+
+const char *const kOpNames[OpCount] = {
+    "create", "createFailed", "update", "show", "focus", "destroy", "cleanupAll", "miss"};
+
+std::atomic<uint64_t> counters[OpCount];
+
+size_t CountOpenFds()
+{
+    size_t count = 0;
+    DIR *dir = opendir("/proc/self/fd");
+    if (!dir)
+    {
+        return 0;
+    }
+    while (dirent *item = readdir(dir))
+    {
+        if (item->d_name[0] != '.')
+        {
+            ++count;
+        }
+    }
+    closedir(dir);
+    return count - 1; // opendir 自身占用的 fd
+}
+
+bool ParseArgs(int argc, char **argv, Config &config)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--")
+        {
+            for (++i; i < argc; ++i)
+            {
+                config.command.push_back(argv[i]);
+            }
+            break;
+        }
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+
+        const char *value = argv[++i];
+        if (arg == "--threads")
+            config.threads = static_cast<unsigned>(std::atoi(value));
+        else if (arg == "--duration")
+            config.durationSec = std::atof(value);
+        else if (arg == "--max-windows")
+            config.maxWindows = static_cast<size_t>(std::atoi(value));
+        else if (arg == "--fail-rate")
+            config.failRate = std::atof(value);
+        else if (arg == "--embed-delay-us")
+            config.embedDelayUs = static_cast<unsigned>(std::atoi(value));
+        else if (arg == "--sample-ms")
+            config.sampleMs = static_cast<unsigned>(std::atoi(value));
+        else if (arg == "--report-every")
+            config.reportEverySec = std::atof(value);
+        else if (arg == "--trace")
+            config.tracePath = value;
+        else
+            return false;
+    }
+    return config.threads > 0 && config.durationSec > 0;
+}
+
+std::string PickId(std::mt19937 &engine)
+{
+    auto ids = WindowManager::Instance().GetAllWindowIds();
+    if (ids.empty())
+    {
+        return "embedded_missing";
+    }
+    return ids[std::uniform_int_distribution<size_t>(0, ids.size() - 1)(engine)];
+}
+
+void Worker(const Config &config, const std::vector<NativeWindow> &hosts,
+            std::chrono::steady_clock::time_point deadline, unsigned seed)
+{
+    WindowManager &manager = WindowManager::Instance();
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int> dice(0, 999);
+    std::uniform_int_distribution<int> coord(0, 1600);
+
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        int roll = dice(engine);
+        Op op;
+
+        if (roll < 250 && manager.GetAllWindowIds().size() < config.maxWindows)
+        {
+            NativeWindow host = hosts[static_cast<size_t>(roll) % hosts.size()];
+            try
+            {
+                manager.CreateEmbeddedWindow(host, L"C:\\stress\\app.exe", L"",
+                                             coord(engine), coord(engine), coord(engine), coord(engine));
+                op = OpCreate;
+            }
+            catch (const std::runtime_error &)
+            {
+                op = OpCreateFailed;
+            }
+        }
+        else if (roll < 550)
+        {
+            op = manager.UpdateWindow(PickId(engine), coord(engine), coord(engine), coord(engine), coord(engine))
+                     ? OpUpdate
+                     : OpMiss;
+        }
+        else if (roll < 700)
+        {
+            op = manager.ShowWindow(PickId(engine), (roll & 1) != 0) ? OpShow : OpMiss;
+        }
+        else if (roll < 800)
+        {
+            op = manager.FocusWindow(PickId(engine)) ? OpFocus : OpMiss;
+        }
+        else if (roll < 997)
+        {
+            op = manager.DestroyWindow(PickId(engine)) ? OpDestroy : OpMiss;
+        }
+        else
+        {
+            manager.CleanupAll();
+            op = OpCleanupAll;
+        }
+
+        counters[op].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint64_t TotalOps()
+{
+    uint64_t total = 0;
+    for (auto &counter : counters)
+    {
+        total += counter.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+bool Check(bool condition, const char *what, size_t actual, size_t expected)
+{
+    std::printf("  %-28s %zu (expected %zu) %s\n", what, actual, expected, condition ? "ok" : "LEAK");
+    return condition;
+}
+}
+
+int main(int argc, char **argv)
+{
+    Config config;
+    if (!ParseArgs(argc, argv, config))
+    {
+        std::fprintf(stderr,
+                     "usage: %s [--threads N] [--duration SEC] [--max-windows N] [--fail-rate P]\n"
+                     "          [--embed-delay-us US] [--sample-ms MS] [--report-every SEC] [--trace FILE]\n"
+                     "          [-- command args...]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    size_t baselineFds = CountOpenFds();
+
+    FakeWindowBackend::Options options = FakeWindowBackend::DefaultOptions();
+    options.containerFailRate = config.failRate;
+    options.launchFailRate = config.failRate;
+    options.embedFailRate = config.failRate;
+    options.embedDelayUs = config.embedDelayUs;
+    if (!config.command.empty())
+    {
+        options.command = config.command;
+    }
+
+    FakeWindowBackend *backend = new FakeWindowBackend(options);
+    WindowManager::Instance().SetBackend(std::unique_ptr<WindowBackend>(backend));
+
+    std::vector<NativeWindow> hosts = {backend->CreateHostWindow(), backend->CreateHostWindow()};
+
+    if (config.sampleMs > 0)
+    {
+        ProcessSampler::Instance().Start(config.sampleMs, 16);
+    }
+
+    if (!config.tracePath.empty())
+    {
+        std::string error;
+        if (!TraceRecorder::Instance().Start(config.tracePath, error))
+        {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+    }
+
+    std::printf("wm_stress: %u threads, %.0fs, max %zu windows, fail rate %.3f\n",
+                config.threads, config.durationSec, config.maxWindows, config.failRate);
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(config.durationSec));
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < config.threads; ++i)
+    {
+        workers.emplace_back(Worker, std::cref(config), std::cref(hosts), deadline, 0x5eed + i);
+    }
+
+    uint64_t lastOps = 0;
+    auto lastReport = start;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        auto now = std::chrono::steady_clock::now();
+        double sinceReport = std::chrono::duration<double>(now - lastReport).count();
+        if (sinceReport < config.reportEverySec)
+        {
+            continue;
+        }
+
+        uint64_t ops = TotalOps();
+        FakeWindowBackend::Stats stats = backend->GetStats();
+        std::printf("[%7.1fs] %10.0f ops/s  registry=%zu windows=%zu children=%zu handles=%zu fds=%zu\n",
+                    std::chrono::duration<double>(now - start).count(),
+                    (ops - lastOps) / sinceReport,
+                    WindowManager::Instance().GetAllWindowIds().size(),
+                    stats.liveWindows, stats.liveProcesses, stats.openHandles, CountOpenFds());
+        std::fflush(stdout);
+        lastOps = ops;
+        lastReport = now;
+    }
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ProcessSampler::Instance().Stop();
+    WindowManager::Instance().CleanupAll();
+    TraceRecorder::Instance().Stop();
+
+    std::printf("\nthroughput over %.1fs:\n", elapsed);
+    for (int op = 0; op < OpCount; ++op)
+    {
+        uint64_t count = counters[op].load();
+        std::printf("  %-14s %12llu  %10.1f/s\n", kOpNames[op], static_cast<unsigned long long>(count), count / elapsed);
+    }
+    std::printf("  %-14s %12llu  %10.1f/s\n", "total", static_cast<unsigned long long>(TotalOps()), TotalOps() / elapsed);
+
+    std::printf("\nleak check:\n");
+    bool ok = true;
+    size_t registry = WindowManager::Instance().GetAllWindowIds().size();
+    ok &= Check(registry == 0, "registry entries", registry, 0);
+
+    size_t sampled = ProcessSampler::Instance().Snapshot().ids.size();
+    ok &= Check(sampled == 0, "sampler entries", sampled, 0);
+
+    FakeWindowBackend::Stats stats = backend->GetStats();
+    ok &= Check(stats.liveWindows == hosts.size(), "windows (incl. hosts)", stats.liveWindows, hosts.size());
+    ok &= Check(stats.liveProcesses == 0, "child processes", stats.liveProcesses, 0);
+    ok &= Check(stats.openHandles == 0, "process/thread handles", stats.openHandles, 0);
+
+    for (NativeWindow host : hosts)
+    {
+        backend->DestroyHostWindow(host);
+    }
+
+    // 所有子进程都应已被回收，不应残留僵尸进程
+    errno = 0;
+    bool noChildren = waitpid(-1, NULL, WNOHANG) == -1 && errno == ECHILD;
+    ok &= Check(noChildren, "unreaped children", noChildren ? 0 : 1, 0);
+
+    size_t fds = CountOpenFds();
+    ok &= Check(fds == baselineFds, "file descriptors", fds, baselineFds);
+
+    std::printf("\n%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,398 @@
+// Replays a WindowManager trace (see src/TraceRecorder.h) against the
+// backend linked into the tool and reports latency distributions per
+// operation, next to the latencies captured when the trace was recorded.
+//
+//   wm_replay TRACE [--speed X] [--embed-delay-us US] [--max-p99-us US]
+//             [--max-mismatches N] [-- command args...]
+//
+// On Windows the real Win32 backend embeds the recorded executables into a
+// real host window, so replayed latencies include the Win32 cost and
+// --max-p99-us can gate releases. On Linux FakeWindowBackend only measures
+// WindowManager's own overhead (plus process spawn/kill for create/destroy);
+// --embed-delay-us and the trailing command configure it.
+//
+// --speed 1 replays at the original pace, 10 ten times faster, 0 as fast as
+// possible. Creates that failed when recorded are skipped. With --max-p99-us
+// set, the run also fails when more than --max-mismatches calls (default 0)
+// returned a different result than when recorded, so a replay whose creates
+// all failed cannot pass on fast failures. Failed replayed creates are left
+// out of the latency samples.
+
+#include "TraceRecorder.h"
+#include "WindowManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include "FakeWindowBackend.h"
+#endif
+
+namespace
+{
+struct Config
+{
+    std::string tracePath;
+    double speed = 1;
+    unsigned embedDelayUs = 0;
+    uint64_t maxP99Us = 0;
+    size_t maxMismatches = 0;
+    std::vector<std::string> command;
+};
+
+bool ParseArgs(int argc, char **argv, Config &config)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--")
+        {
+            for (++i; i < argc; ++i)
+            {
+                config.command.push_back(argv[i]);
+            }
+            break;
+        }
+        if (arg.compare(0, 2, "--") != 0)
+        {
+            config.tracePath = arg;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+
+        const char *value = argv[++i];
+        if (arg == "--speed")
+            config.speed = std::atof(value);
+        else if (arg == "--embed-delay-us")
+            config.embedDelayUs = static_cast<unsigned>(std::atoi(value));
+        else if (arg == "--max-p99-us")
+            config.maxP99Us = std::strtoull(value, nullptr, 10);
+        else if (arg == "--max-mismatches")
+            config.maxMismatches = static_cast<size_t>(std::strtoull(value, nullptr, 10));
+        else
+            return false;
+    }
+    return !config.tracePath.empty() && config.speed >= 0;
+}
+
+uint64_t Percentile(const std::vector<uint64_t> &sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(p * sorted.size());
+    if (index >= sorted.size())
+    {
+        index = sorted.size() - 1;
+    }
+    return sorted[index];
+}
+
+void PrintRow(const char *name, std::vector<uint64_t> &recorded, std::vector<uint64_t> &replayed)
+{
+    std::sort(recorded.begin(), recorded.end());
+    std::sort(replayed.begin(), replayed.end());
+    std::printf("  %-8s %8zu | %8llu %8llu %8llu %9llu | %8llu %8llu %8llu %9llu\n",
+                name, replayed.size(),
+                static_cast<unsigned long long>(Percentile(recorded, 0.5)),
+                static_cast<unsigned long long>(Percentile(recorded, 0.9)),
+                static_cast<unsigned long long>(Percentile(recorded, 0.99)),
+                static_cast<unsigned long long>(recorded.empty() ? 0 : recorded.back()),
+                static_cast<unsigned long long>(Percentile(replayed, 0.5)),
+                static_cast<unsigned long long>(Percentile(replayed, 0.9)),
+                static_cast<unsigned long long>(Percentile(replayed, 0.99)),
+                static_cast<unsigned long long>(replayed.empty() ? 0 : replayed.back()));
+}
+
+uint64_t ElapsedUs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+    return us > 0 ? static_cast<uint64_t>(us) : 0;
+}
+
+// Host window that the replayed windows are embedded into.
+class ReplayHost
+{
+public:
+    explicit ReplayHost(const Config &config);
+    ~ReplayHost();
+
+    NativeWindow Window() const { return window_; }
+
+    // Dispatches pending window messages; embedded apps talk to the host and
+    // container windows, which live on this thread.
+    void PumpMessages();
+    void WaitUntil(std::chrono::steady_clock::time_point target);
+
+private:
+    NativeWindow window_;
+#ifndef _WIN32
+    FakeWindowBackend *backend_;
+#endif
+};
+
+#ifdef _WIN32
+ReplayHost::ReplayHost(const Config &config)
+{
+    if (config.embedDelayUs > 0 || !config.command.empty())
+    {
+        std::fprintf(stderr, "warning: --embed-delay-us and command only apply to the fake backend, ignored\n");
+    }
+
+    WNDCLASSEXW wcx = {};
+    wcx.cbSize = sizeof(wcx);
+    wcx.lpfnWndProc = DefWindowProcW;
+    wcx.hInstance = GetModuleHandle(NULL);
+    wcx.hCursor = LoadCursor(NULL, IDC_ARROW);
+    wcx.lpszClassName = L"WindowManagerReplayHost";
+    RegisterClassExW(&wcx);
+
+    window_ = CreateWindowExW(0, wcx.lpszClassName, L"wm_replay", WS_OVERLAPPEDWINDOW | WS_VISIBLE,
+                              CW_USEDEFAULT, CW_USEDEFAULT, 1280, 800, NULL, NULL, wcx.hInstance, NULL);
+    PumpMessages();
+}
+
+ReplayHost::~ReplayHost()
+{
+    if (window_)
+    {
+        ::DestroyWindow(static_cast<HWND>(window_));
+    }
+    UnregisterClassW(L"WindowManagerReplayHost", GetModuleHandle(NULL));
+}
+
+void ReplayHost::PumpMessages()
+{
+    MSG msg;
+    while (PeekMessageW(&msg, NULL, 0, 0, PM_REMOVE))
+    {
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
+    }
+}
+
+void ReplayHost::WaitUntil(std::chrono::steady_clock::time_point target)
+{
+    for (;;)
+    {
+        PumpMessages();
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(target - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0)
+        {
+            break;
+        }
+        MsgWaitForMultipleObjects(0, NULL, FALSE, static_cast<DWORD>(remaining.count()), QS_ALLINPUT);
+    }
+    // 毫秒级等待的余量用忙等补齐
+    while (std::chrono::steady_clock::now() < target)
+    {
+    }
+}
+#else
+ReplayHost::ReplayHost(const Config &config)
+{
+    FakeWindowBackend::Options options = FakeWindowBackend::DefaultOptions();
+    options.embedDelayUs = config.embedDelayUs;
+    if (!config.command.empty())
+    {
+        options.command = config.command;
+    }
+    backend_ = new FakeWindowBackend(options);
+    WindowManager::Instance().SetBackend(std::unique_ptr<WindowBackend>(backend_));
+    window_ = backend_->CreateHostWindow();
+}
+
+ReplayHost::~ReplayHost()
+{
+    backend_->DestroyHostWindow(window_);
+}
+
+void ReplayHost::PumpMessages()
+{
+}
+
+void ReplayHost::WaitUntil(std::chrono::steady_clock::time_point target)
+{
+    std::this_thread::sleep_until(target);
+}
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    Config config;
+    if (!ParseArgs(argc, argv, config))
+    {
+        std::fprintf(stderr,
+                     "usage: %s TRACE [--speed X] [--embed-delay-us US] [--max-p99-us US]\n"
+                     "          [--max-mismatches N] [-- command args...]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    std::vector<TraceRecord> records;
+    std::string error;
+    if (!TraceRecorder::ReadTrace(config.tracePath, records, error))
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 2;
+    }
+    if (!error.empty())
+    {
+        std::fprintf(stderr, "warning: %s, replaying %zu records\n", error.c_str(), records.size());
+    }
+
+    // 多线程录制时记录按完成顺序写入，回放按调用开始时间排序
+    std::stable_sort(records.begin(), records.end(), [](const TraceRecord &a, const TraceRecord &b)
+                     { return a.timestampUs < b.timestampUs; });
+
+    WindowManager &manager = WindowManager::Instance();
+    ReplayHost host(config);
+    if (!host.Window())
+    {
+        std::fprintf(stderr, "Failed to create replay host window\n");
+        return 2;
+    }
+
+    std::map<std::string, std::string> idMap;
+    std::map<int, std::vector<uint64_t>> recordedUs;
+    std::map<int, std::vector<uint64_t>> replayedUs;
+    std::vector<uint64_t> lagUs;
+    size_t mismatches = 0;
+    size_t skipped = 0;
+
+    std::printf("wm_replay: %zu records, %.3fs recorded, ", records.size(),
+                records.empty() ? 0.0 : records.back().timestampUs / 1e6);
+    if (config.speed > 0)
+        std::printf("speed %gx\n", config.speed);
+    else
+        std::printf("speed max\n");
+
+    auto start = std::chrono::steady_clock::now();
+    for (const TraceRecord &record : records)
+    {
+        // 录制时失败的创建在回放环境中通常会成功，回放它只会多出录制里不存在的窗口
+        if (record.op == TraceCreate && !record.ok)
+        {
+            ++skipped;
+            continue;
+        }
+
+        if (config.speed > 0)
+        {
+            auto target = start + std::chrono::microseconds(static_cast<int64_t>(record.timestampUs / config.speed));
+            host.WaitUntil(target);
+            lagUs.push_back(ElapsedUs(target, std::chrono::steady_clock::now()));
+        }
+        else
+        {
+            host.PumpMessages();
+        }
+
+        auto mapped = idMap.find(record.id);
+        const std::string &id = mapped != idMap.end() ? mapped->second : record.id;
+
+        bool ok = false;
+        auto begin = std::chrono::steady_clock::now();
+        switch (record.op)
+        {
+        case TraceCreate:
+            try
+            {
+                std::string newId = manager.CreateEmbeddedWindow(host.Window(), record.exePath, record.args,
+                                                                 record.x, record.y, record.width, record.height);
+                if (!record.id.empty())
+                {
+                    idMap[record.id] = newId;
+                }
+                ok = true;
+            }
+            catch (const std::runtime_error &)
+            {
+            }
+            break;
+        case TraceUpdate:
+            ok = manager.UpdateWindow(id, record.x, record.y, record.width, record.height);
+            break;
+        case TraceShow:
+            ok = manager.ShowWindow(id, record.show);
+            break;
+        case TraceDestroy:
+            ok = manager.DestroyWindow(id);
+            break;
+        }
+        uint64_t latency = ElapsedUs(begin, std::chrono::steady_clock::now());
+
+        recordedUs[record.op].push_back(record.durationUs);
+        // 失败的创建在参数校验处就返回，耗时不代表真实嵌入开销
+        if (record.op != TraceCreate || ok)
+        {
+            replayedUs[record.op].push_back(latency);
+        }
+        if (ok != record.ok)
+        {
+            ++mismatches;
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    manager.CleanupAll();
+
+    std::printf("replayed in %.3fs, %zu result mismatches, %zu failed creates skipped\n\n",
+                elapsed, mismatches, skipped);
+    std::printf("  %-8s %8s | %-37s | %s\n", "", "", "recorded (us)", "replayed (us)");
+    std::printf("  %-8s %8s | %8s %8s %8s %9s | %8s %8s %8s %9s\n",
+                "op", "count", "p50", "p90", "p99", "max", "p50", "p90", "p99", "max");
+
+    bool ok = true;
+    for (int op = TraceCreate; op <= TraceDestroy; ++op)
+    {
+        if (recordedUs[op].empty())
+        {
+            continue;
+        }
+        PrintRow(TraceRecorder::OpName(static_cast<TraceOp>(op)), recordedUs[op], replayedUs[op]);
+
+        uint64_t p99 = Percentile(replayedUs[op], 0.99);
+        if (config.maxP99Us > 0 && p99 > config.maxP99Us)
+        {
+            std::printf("  -> %s p99 %lluus exceeds budget %lluus\n", TraceRecorder::OpName(static_cast<TraceOp>(op)),
+                        static_cast<unsigned long long>(p99), static_cast<unsigned long long>(config.maxP99Us));
+            ok = false;
+        }
+    }
+
+    if (!lagUs.empty())
+    {
+        std::sort(lagUs.begin(), lagUs.end());
+        std::printf("\n  schedule lag (us): p50 %llu  p99 %llu  max %llu\n",
+                    static_cast<unsigned long long>(Percentile(lagUs, 0.5)),
+                    static_cast<unsigned long long>(Percentile(lagUs, 0.99)),
+                    static_cast<unsigned long long>(lagUs.back()));
+    }
+
+    if (config.maxP99Us > 0 && mismatches > config.maxMismatches)
+    {
+        std::printf("\n  -> %zu result mismatches exceed limit %zu\n", mismatches, config.maxMismatches);
+        ok = false;
+    }
+
+    if (config.maxP99Us > 0)
+    {
+        std::printf("\n%s\n", ok ? "PASS" : "FAIL");
+    }
+    return ok ? 0 : 1;
+}